@@ -6,7 +6,7 @@ bool Game::Init() {
 	m_scene = new LEN::Scene();
 
 	auto camera = m_scene->CreateObject("Camera");
-	camera->AddComponent(new LEN::CameraComponent);
+	camera->AddComponent<LEN::CameraComponent>();
 	camera->SetPosition(glm::vec3(0.0f, 0.0f, 2.0f));
 
 	m_scene->SetMainCamera(camera);
@@ -1,5 +1,4 @@
 #include "TestObject.hpp"
-#include <GLFW/glfw3.h>
 #include <iostream>
 
 TestObject::TestObject()
@@ -9,18 +8,17 @@ TestObject::TestObject()
         #version 330 core
         layout (location = 0) in vec3 position;
         layout (location = 1) in vec3 color;
+        layout (location = 12) in mat4 aInstanceModel; // Filled by the engine, opts in to instancing
 
         out vec3 vColor;
 
-        uniform mat4 uModel;
-        uniform mat4 uView;
-        uniform mat4 uProjection;
+        #include <LEN/FrameUniforms.glsl>
 
 
         void main()
         {
             vColor = color;
-            gl_Position = uProjection * uView * uModel * vec4(position, 1.0);
+            gl_Position = uViewProjection * aInstanceModel * vec4(position, 1.0);
         }
     )";
 
@@ -30,10 +28,14 @@ TestObject::TestObject()
 
         in vec3 vColor;
 
+        layout (std140) uniform MaterialParams
+        {
+            vec4 uColor;
+        };
+
         void main()
         {
-            // Use vertex color directly to avoid relying on material uniform support for vec4
-            FragColor = vec4(vColor, 1.0);
+            FragColor = vec4(vColor, 1.0) * uColor;
         }
     )";
 
@@ -44,6 +46,7 @@ TestObject::TestObject()
 
 	auto material = std::make_shared<LEN::Material>();
 	material->SetShaderProgram(shaderProgram); // Set the shader program to the material
+	material->SetParam(LEN::StringId::Intern("uColor"), glm::vec4(1.0f)); // Tints the vertex colors
 
 
 	std::vector<float> vertices =
@@ -70,10 +73,14 @@ TestObject::TestObject()
 	vertexLayout.elements.push_back({ 1, 3, GL_FLOAT, sizeof(float) * 3 });
 	vertexLayout.stride = sizeof(float) * 6; // 3 for position + 3 for color
 
+	// Half positions and 8-bit colors: 12 bytes per vertex instead of 24
+	auto encoded = LEN::VertexCompression::Encode(vertexLayout, vertices,
+		{ LEN::VertexSemantic::Position, LEN::VertexSemantic::Color });
+
 	// Create Mesh
-	auto mesh = std::make_shared<LEN::Mesh>(vertexLayout, vertices, indices);
+	auto mesh = std::make_shared<LEN::Mesh>(encoded.layout, encoded.data, indices);
 
-	AddComponent(new LEN::MeshComponent(material, mesh));
+	AddComponent<LEN::MeshComponent>(material, mesh);
 }
 
 void TestObject::Update(float deltaTime)
@@ -3,18 +3,68 @@
 // ============================================================================
 #include "Game.hpp"
 #include "Core/eng.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
 
 
-int main() {
+int main(int argc, char** argv) {
 
 	Game* game = new Game();
 	LEN::Engine& engine = LEN::Engine::GetInstance();
 	engine.SetApplication(game);
 
+	// --headless runs without a window or GPU, --frames=N stops after N frames.
+	// --record=FILE saves the session's input, --replay=FILE plays one back (uncapped unless
+	// --paced) and reports frame times, --timings=FILE also writes them as CSV.
+	std::string replayPath;
+	std::string timingsPath;
+	bool paced = false;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg(argv[i]);
+		if (arg == "--headless") {
+			engine.SetHeadless(true);
+		}
+		else if (arg.starts_with("--frames=")) {
+			engine.SetFrameLimit(std::strtoull(argv[i] + 9, nullptr, 10));
+		}
+		else if (arg.starts_with("--record=")) {
+			engine.RecordInput(std::string(arg.substr(9)));
+		}
+		else if (arg.starts_with("--replay=")) {
+			replayPath = arg.substr(9);
+		}
+		else if (arg.starts_with("--timings=")) {
+			timingsPath = arg.substr(10);
+		}
+		else if (arg == "--paced") {
+			paced = true;
+		}
+	}
+
+	if (!replayPath.empty() && !engine.ReplayInput(replayPath, !paced)) {
+		return EXIT_FAILURE;
+	}
+	if (!timingsPath.empty()) {
+		engine.GetFrameTimings().SetEnabled(true);
+	}
+
 	if (!engine.Init(1280, 720)) {
 		return EXIT_FAILURE;
 	}
 
 	engine.Run();
+
+	auto& timings = engine.GetFrameTimings();
+	if (timings.IsEnabled()) {
+		const auto summary = timings.Summarize();
+		std::cout << "Frames: " << summary.count << ", CPU ms mean " << summary.mean << ", min " << summary.min
+			<< ", p50 " << summary.p50 << ", p90 " << summary.p90 << ", p99 " << summary.p99
+			<< ", max " << summary.max << std::endl;
+		if (!timingsPath.empty()) {
+			timings.WriteCsv(timingsPath);
+		}
+	}
 	engine.Destroy();
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string_view>
+
+namespace LEN::Bench
+{
+	class Stopwatch
+	{
+	public:
+		Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+		void Restart() { m_start = std::chrono::steady_clock::now(); }
+		double ElapsedMs() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	// Value of a "--name=N" argument, fallback when it is absent
+	inline size_t Arg(int argc, char** argv, std::string_view name, size_t fallback)
+	{
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg(argv[i]);
+			if (arg.size() > name.size() + 3 && arg.starts_with("--") && arg.substr(2, name.size()) == name
+				&& arg[name.size() + 2] == '=') {
+				return std::strtoull(argv[i] + name.size() + 3, nullptr, 10);
+			}
+		}
+		return fallback;
+	}
+
+	// Results are folded into this so the compiler cannot drop the measured work
+	inline volatile float g_sink = 0.0f;
+}
\ No newline at end of file
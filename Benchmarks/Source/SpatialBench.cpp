@@ -0,0 +1,178 @@
+// ============================================================================
+// SpatialBench.cpp - DynamicBVH query throughput against scene size
+// ============================================================================
+// Fills the tree with random boxes at a constant density, so only the proxy count changes
+// between sizes, and times every query kind per query. Raycasts and overlaps are also timed as
+// a linear scan over all boxes, the cost of a query without the index. Batched queries run on
+// the job system.
+// Usage: SpatialBench [--max=100000] [--queries=10000] [--k=8] [--threads=0]
+#include "Bench.hpp"
+#include "Core/spatial/DynamicBVH.hpp"
+#include "Core/jobs/JobSystem.hpp"
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	bool RayHitsBox(const LEN::Ray& ray, const LEN::AABB& box, float& distance)
+	{
+		float tMin = 0.0f;
+		float tMax = ray.maxDistance;
+		for (int axis = 0; axis < 3; ++axis) {
+			const float inverse = 1.0f / ray.direction[axis];
+			float t0 = (box.min[axis] - ray.origin[axis]) * inverse;
+			float t1 = (box.max[axis] - ray.origin[axis]) * inverse;
+			if (inverse < 0.0f) {
+				std::swap(t0, t1);
+			}
+			tMin = std::max(tMin, t0);
+			tMax = std::min(tMax, t1);
+			if (tMax < tMin) {
+				return false;
+			}
+		}
+		distance = tMin;
+		return true;
+	}
+
+	template<typename Fn>
+	void Report(const char* label, size_t queries, Fn&& fn)
+	{
+		LEN::Bench::Stopwatch stopwatch;
+		const size_t results = fn();
+		const double us = stopwatch.ElapsedMs() * 1000.0 / static_cast<double>(queries);
+		std::printf("  %-28s %10.3f us/query  %12.0f queries/s  %8.2f results/query\n", label, us, 1e6 / us,
+			static_cast<double>(results) / static_cast<double>(queries));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const size_t maxProxies = LEN::Bench::Arg(argc, argv, "max", 100000);
+	const size_t queries = std::max<size_t>(LEN::Bench::Arg(argc, argv, "queries", 10000), 1);
+	const size_t k = std::max<size_t>(LEN::Bench::Arg(argc, argv, "k", 8), 1);
+	const size_t bruteQueries = std::max<size_t>(queries / 10, 1); // The linear scans are slow at large sizes
+
+	LEN::JobSystem jobSystem;
+	jobSystem.Init(static_cast<uint32_t>(LEN::Bench::Arg(argc, argv, "threads", 0)));
+	std::printf("%zu queries per kind (%zu for linear scans), k = %zu, %u threads\n", queries, bruteQueries, k,
+		jobSystem.GetThreadCount());
+
+	for (size_t proxyCount = 1000; proxyCount <= maxProxies; proxyCount *= 10) {
+		// Boxes of 0.5 to 2 units; the world grows with the count so the density stays the same
+		const float worldSize = 4.0f * std::cbrt(static_cast<float>(proxyCount));
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> coordinate(0.0f, worldSize);
+		std::uniform_real_distribution<float> size(0.5f, 2.0f);
+		std::normal_distribution<float> normal(0.0f, 1.0f);
+
+		std::vector<LEN::AABB> boxes(proxyCount);
+		for (LEN::AABB& box : boxes) {
+			box.min = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+			box.max = box.min + glm::vec3(size(random), size(random), size(random));
+		}
+
+		std::vector<LEN::Ray> rays(queries);
+		std::vector<glm::vec3> points(queries);
+		for (size_t i = 0; i < queries; ++i) {
+			rays[i].origin = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+			rays[i].direction = glm::normalize(glm::vec3(normal(random), normal(random), normal(random)));
+			rays[i].maxDistance = worldSize;
+			points[i] = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+		}
+
+		std::printf("%zu proxies\n", proxyCount);
+		LEN::DynamicBVH tree;
+		Report("CreateProxy (per proxy)", proxyCount, [&] {
+			for (size_t i = 0; i < proxyCount; ++i) {
+				tree.CreateProxy(boxes[i], nullptr);
+			}
+			return size_t(0);
+		});
+
+		Report("RaycastClosest", queries, [&] {
+			size_t hits = 0;
+			for (const LEN::Ray& ray : rays) {
+				LEN::RayHit hit;
+				hits += tree.RaycastClosest(ray, hit) ? 1 : 0;
+			}
+			return hits;
+		});
+		Report("RaycastClosest, linear scan", bruteQueries, [&] {
+			size_t hits = 0;
+			for (size_t i = 0; i < bruteQueries; ++i) {
+				float closest = rays[i].maxDistance;
+				bool hit = false;
+				for (const LEN::AABB& box : boxes) {
+					float distance = 0.0f;
+					if (RayHitsBox(rays[i], box, distance) && distance <= closest) {
+						closest = distance;
+						hit = true;
+					}
+				}
+				hits += hit ? 1 : 0;
+			}
+			return hits;
+		});
+		std::vector<LEN::RayHit> rayHits(queries);
+		Report("RaycastBatch", queries, [&] {
+			tree.RaycastBatch(rays.data(), rayHits.data(), queries, &jobSystem);
+			return static_cast<size_t>(std::count_if(rayHits.begin(), rayHits.end(),
+				[](const LEN::RayHit& hit) { return hit.proxy != LEN::NullProxy; }));
+		});
+
+		Report("QueryOverlap (4 unit box)", queries, [&] {
+			size_t results = 0;
+			for (const glm::vec3& point : points) {
+				tree.QueryOverlap(LEN::AABB{ point - glm::vec3(2.0f), point + glm::vec3(2.0f) }, [&](LEN::ProxyId) {
+					++results;
+					return true;
+				});
+			}
+			return results;
+		});
+		Report("QueryOverlap, linear scan", bruteQueries, [&] {
+			size_t results = 0;
+			for (size_t i = 0; i < bruteQueries; ++i) {
+				const LEN::AABB query{ points[i] - glm::vec3(2.0f), points[i] + glm::vec3(2.0f) };
+				for (const LEN::AABB& box : boxes) {
+					results += box.Overlaps(query) ? 1 : 0;
+				}
+			}
+			return results;
+		});
+		Report("QuerySphere (radius 2)", queries, [&] {
+			size_t results = 0;
+			for (const glm::vec3& point : points) {
+				tree.QuerySphere(point, 2.0f, [&](LEN::ProxyId) {
+					++results;
+					return true;
+				});
+			}
+			return results;
+		});
+
+		std::vector<LEN::ProxyId> nearest(queries * k);
+		Report("QueryNearest", queries, [&] {
+			size_t results = 0;
+			for (size_t i = 0; i < queries; ++i) {
+				results += tree.QueryNearest(points[i], k, nearest.data() + i * k);
+			}
+			return results;
+		});
+		Report("QueryNearestBatch", queries, [&] {
+			tree.QueryNearestBatch(points.data(), queries, k, nearest.data(), &jobSystem);
+			return static_cast<size_t>(std::count_if(nearest.begin(), nearest.end(),
+				[](LEN::ProxyId proxy) { return proxy != LEN::NullProxy; }));
+		});
+	}
+
+	jobSystem.Shutdown();
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
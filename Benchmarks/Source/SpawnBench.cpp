@@ -0,0 +1,134 @@
+// ============================================================================
+// SpawnBench.cpp - heap allocations and throughput of spawning and clearing objects
+// ============================================================================
+// Spawns rounds of projectiles (a named object plus one component) into a scene, then drops
+// them. Global operator new is replaced by a counting one, so the allocations of every phase
+// are reported next to its time. Components come from the scene pools (AddComponent<T>) and,
+// for comparison, from the heap (AddComponent(new T)); objects are dropped with Scene::Clear
+// and, for comparison, one by one through MarkForDestroy.
+// Usage: SpawnBench [--objects=100000] [--rounds=5]
+#include "Bench.hpp"
+#include "Core/scene/Scene.hpp"
+#include "Core/scene/Component.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace
+{
+	std::atomic<size_t> g_allocations{ 0 };
+
+	void* CountedAllocate(size_t size, size_t alignment)
+	{
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		size = std::max<size_t>(size, 1);
+#if defined(_MSC_VER)
+		void* block = _aligned_malloc(size, alignment);
+#else
+		void* block = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+		if (!block) {
+			throw std::bad_alloc();
+		}
+		return block;
+	}
+
+	void CountedFree(void* block)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(block);
+#else
+		std::free(block);
+#endif
+	}
+
+	class Projectile : public LEN::Component
+	{
+		COMPONENT(Projectile)
+	public:
+		void Update(float deltaTime) override { m_lifetime -= deltaTime; }
+
+	private:
+		float m_lifetime = 5.0f;
+	};
+
+	struct Phase
+	{
+		double ms = 0.0;
+		size_t allocations = 0;
+	};
+
+	template<typename Fn>
+	Phase Measure(Fn&& fn)
+	{
+		const size_t allocations = g_allocations.load(std::memory_order_relaxed);
+		LEN::Bench::Stopwatch stopwatch;
+		fn();
+		return { stopwatch.ElapsedMs(), g_allocations.load(std::memory_order_relaxed) - allocations };
+	}
+
+	void Spawn(LEN::Scene& scene, size_t count, bool pooledComponents)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			LEN::GameObject* projectile = scene.CreateObject("Projectile");
+			if (pooledComponents) {
+				projectile->AddComponent<Projectile>();
+			}
+			else {
+				projectile->AddComponent(new Projectile());
+			}
+		}
+	}
+
+	void Report(const char* label, const Phase& phase, size_t count)
+	{
+		std::printf("  %-34s %9.3f ms  %8.1f ns/object  %6.3f allocations/object\n", label, phase.ms,
+			phase.ms * 1e6 / static_cast<double>(count), static_cast<double>(phase.allocations) / static_cast<double>(count));
+	}
+}
+
+// Replaceable global allocation functions; the aligned forms are routed here as well
+void* operator new(size_t size) { return CountedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return CountedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAllocate(size, static_cast<size_t>(alignment)); }
+void operator delete(void* block) noexcept { CountedFree(block); }
+void operator delete[](void* block) noexcept { CountedFree(block); }
+void operator delete(void* block, size_t) noexcept { CountedFree(block); }
+void operator delete[](void* block, size_t) noexcept { CountedFree(block); }
+void operator delete(void* block, std::align_val_t) noexcept { CountedFree(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { CountedFree(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { CountedFree(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { CountedFree(block); }
+
+int main(int argc, char** argv)
+{
+	const size_t objectCount = std::max<size_t>(LEN::Bench::Arg(argc, argv, "objects", 100000), 1);
+	const size_t rounds = std::max<size_t>(LEN::Bench::Arg(argc, argv, "rounds", 5), 1);
+
+	std::printf("%zu projectiles per round, %zu rounds\n", objectCount, rounds);
+	LEN::Scene scene;
+	for (size_t round = 0; round < rounds; ++round) {
+		// The first round also grows the scene's registries, later ones show the steady state
+		std::printf("round %zu\n", round);
+		Report("spawn, pooled components", Measure([&] { Spawn(scene, objectCount, true); }), objectCount);
+		Report("Scene::Clear", Measure([&] { scene.Clear(); }), objectCount);
+
+		Report("spawn, heap components", Measure([&] { Spawn(scene, objectCount, false); }), objectCount);
+		std::vector<LEN::GameObject*> objects;
+		objects.reserve(scene.GetRootCount());
+		for (size_t i = 0; i < scene.GetRootCount(); ++i) {
+			objects.push_back(scene.GetRoot(i));
+		}
+		Report("MarkForDestroy + Update", Measure([&] {
+			for (LEN::GameObject* object : objects) {
+				object->MarkForDestroy();
+			}
+			scene.Update(0.0f);
+		}), objectCount);
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+// ============================================================================
+// TransformBench.cpp - world transform update throughput
+// ============================================================================
+// Compares the former per-object transforms (one heap object each, world matrix rebuilt
+// recursively through the parent pointers) with TransformStore's SoA batch update.
+// Every frame moves every object and recomputes every world matrix.
+// Usage: TransformBench [--objects=100000] [--depth=8] [--frames=30]
+#include "Bench.hpp"
+#include "Core/scene/TransformStore.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// The transform part of GameObject before the store, kept as the baseline
+	struct LegacyTransform
+	{
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 rotation = glm::vec3(0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+		LegacyTransform* parent = nullptr;
+
+		glm::mat4 GetLocalTransform() const
+		{
+			glm::mat4 mat = glm::translate(glm::mat4(1.0f), position);
+			mat = glm::rotate(mat, rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
+			mat = glm::rotate(mat, rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
+			mat = glm::rotate(mat, rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+			return glm::scale(mat, scale);
+		}
+
+		glm::mat4 GetWorldTransform() const
+		{
+			return parent ? parent->GetWorldTransform() * GetLocalTransform() : GetLocalTransform();
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	const size_t objectCount = LEN::Bench::Arg(argc, argv, "objects", 100000);
+	const size_t depth = std::max<size_t>(LEN::Bench::Arg(argc, argv, "depth", 8), 1);
+	const size_t frames = std::max<size_t>(LEN::Bench::Arg(argc, argv, "frames", 30), 1);
+
+	// Chains of depth objects, each one parented to the previous
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> scale(0.8f, 1.2f);
+
+	std::vector<std::unique_ptr<LegacyTransform>> legacy;
+	LEN::TransformStore store;
+	std::vector<LEN::TransformId> ids;
+	legacy.reserve(objectCount);
+	store.Reserve(objectCount);
+	ids.reserve(objectCount);
+	for (size_t i = 0; i < objectCount; ++i) {
+		const bool root = i % depth == 0;
+		auto transform = std::make_unique<LegacyTransform>();
+		transform->position = root ? glm::vec3(offset(random), offset(random), offset(random)) : glm::vec3(1.0f, 0.5f, 0.0f);
+		transform->rotation = glm::vec3(angle(random), angle(random), angle(random));
+		transform->scale = glm::vec3(scale(random));
+		transform->parent = root ? nullptr : legacy.back().get();
+
+		const LEN::TransformId id = store.Create();
+		if (!root) {
+			store.SetParent(id, ids.back());
+		}
+		store.SetPosition(id, transform->position);
+		store.SetEulerRotation(id, transform->rotation);
+		store.SetScale(id, transform->scale);
+
+		legacy.push_back(std::move(transform));
+		ids.push_back(id);
+	}
+	store.Update();
+
+	// Former path: every consumer asked each object for its world matrix
+	std::vector<glm::mat4> legacyWorld(objectCount);
+	LEN::Bench::Stopwatch stopwatch;
+	for (size_t frame = 0; frame < frames; ++frame) {
+		const float shift = static_cast<float>(frame) * 0.01f;
+		for (size_t i = 0; i < objectCount; ++i) {
+			legacy[i]->position.y += shift;
+		}
+		for (size_t i = 0; i < objectCount; ++i) {
+			legacyWorld[i] = legacy[i]->GetWorldTransform();
+		}
+		LEN::Bench::g_sink = LEN::Bench::g_sink + legacyWorld[frame % objectCount][3][0];
+	}
+	const double legacyMs = stopwatch.ElapsedMs() / static_cast<double>(frames);
+
+	stopwatch.Restart();
+	for (size_t frame = 0; frame < frames; ++frame) {
+		const float shift = static_cast<float>(frame) * 0.01f;
+		for (size_t i = 0; i < objectCount; ++i) {
+			glm::vec3 position = store.GetPosition(ids[i]);
+			position.y += shift;
+			store.SetPosition(ids[i], position);
+		}
+		store.Update();
+		LEN::Bench::g_sink = LEN::Bench::g_sink + store.GetWorldMatrix(ids[frame % objectCount])[3][0];
+	}
+	const double storeMs = stopwatch.ElapsedMs() / static_cast<double>(frames);
+
+	// Both paths applied the same moves, so they must agree
+	float maxError = 0.0f;
+	for (size_t i = 0; i < objectCount; ++i) {
+		const glm::mat4 world = store.GetWorldMatrix(ids[i]);
+		for (int column = 0; column < 4; ++column) {
+			for (int row = 0; row < 4; ++row) {
+				const float expected = legacyWorld[i][column][row];
+				const float error = std::abs(world[column][row] - expected) / std::max(1.0f, std::abs(expected));
+				maxError = std::max(maxError, error);
+			}
+		}
+	}
+
+	std::printf("%zu objects, depth %zu, %zu frames\n", objectCount, depth, frames);
+	std::printf("  recursive GetWorldTransform: %8.3f ms/frame\n", legacyMs);
+	std::printf("  TransformStore::Update:      %8.3f ms/frame\n", storeMs);
+	std::printf("  speedup %.2fx, max relative error %g\n", legacyMs / storeMs, maxError);
+	return maxError <= 1e-3f ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
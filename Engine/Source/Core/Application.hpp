@@ -4,6 +4,7 @@ namespace LEN
 {
 	class Application {
 	public:
+		virtual ~Application() = default; // Owned and deleted by the Engine
 		virtual bool Init() = 0;
 
 		// Deltatime in seconds
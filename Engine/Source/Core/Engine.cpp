@@ -2,17 +2,39 @@
 #include "Application.hpp"
 #include "scene/Component.hpp"
 #include "scene/components/CameraComponent.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <GL/glew.h>
+#ifndef LEN_HEADLESS_ONLY
 #include <GLFW/glfw3.h>
+#endif
 #include <iostream>
+#include <thread>
 
 
 namespace LEN {
+#ifdef LEN_HEADLESS_ONLY
+    namespace {
+        // No GLFW in headless-only builds. m_window stays null, so the window calls of Run and
+        // Destroy are never reached and only need to compile.
+        void glfwSwapInterval(int) {}
+        void glfwMakeContextCurrent(GLFWwindow *) {}
+        void glfwSwapBuffers(GLFWwindow *) {}
+        int glfwWindowShouldClose(GLFWwindow *) { return 1; }
+        void glfwPollEvents() {}
+        void glfwGetWindowSize(GLFWwindow *, int *, int *) {}
+        void glfwDestroyWindow(GLFWwindow *) {}
+        void glfwTerminate() {}
+    }
+#endif
+
     Engine::Engine() = default;
 
     Engine::~Engine() = default;
 
+#ifndef LEN_HEADLESS_ONLY
+
     LEN::Key GLFWKeyToKey(int glfwKey) {
         using KEY = LEN::Key;
         if (glfwKey >= GLFW_KEY_A && glfwKey <= GLFW_KEY_Z)
@@ -35,13 +57,17 @@ namespace LEN {
         auto mapped = GLFWKeyToKey(key);
         if (mapped == LEN::Key::Unknown) return; // ignore unmapped keys
 
-        auto &inputManager = LEN::Engine::GetInstance().GetInputManager();
+        auto &engine = LEN::Engine::GetInstance();
+        if (engine.IsReplaying()) return; // Keys come from the recording
+
+        auto &inputManager = engine.GetInputManager();
 
         if (action == GLFW_PRESS || action == GLFW_REPEAT)
             inputManager.SetKeyPressed(mapped, true);
         else if (action == GLFW_RELEASE)
             inputManager.SetKeyPressed(mapped, false);
     }
+#endif
 
     Engine &Engine::GetInstance() {
         static Engine instance;
@@ -54,6 +80,23 @@ namespace LEN {
             return false;
         }
 
+        m_jobSystem.Init(m_jobThreadCount);
+        m_renderQueue.SetThreadCount(m_jobSystem.GetThreadCount());
+        m_renderQueue.SetJobSystem(&m_jobSystem);
+
+        m_width = width;
+        m_height = height;
+#ifdef LEN_HEADLESS_ONLY
+        m_headless = true; // Built without GLFW and GL
+#endif
+        m_graphicsAPI.SetHeadless(m_headless);
+        m_graphicsAPI.SetRenderThread(&m_renderThread);
+        if (m_headless) {
+            return m_application->Init(); // No window, context or GLEW
+        }
+
+#ifndef LEN_HEADLESS_ONLY
+
         if (!glfwInit()) {
             std::cerr << "Failed to initialize GLFW" << std::endl;
             return false;
@@ -94,49 +137,166 @@ namespace LEN {
             m_window = nullptr;
             return false;
         }
+#endif
 
         return m_application->Init();
     }
 
     void Engine::Run() {
-        if (!m_application || !m_window) return;
+        if (!m_application || (!m_window && !m_headless)) return;
+
+        m_accumulator = 0.0f;
+        m_time = 0.0f;
+        m_frameCount = 0;
+        m_frameTimings.Clear();
+        if (m_replaying) {
+            m_inputManager.ReleaseAll(); // Recordings start from released keys
+            m_frameTimings.Reserve(m_inputRecording.GetFrameCount());
+            if (m_window && m_replayUncapped) {
+                glfwSwapInterval(0);
+            }
+        }
+        else if (m_recording) {
+            m_inputRecording.Clear();
+        }
 
-        m_lastTimePoint = std::chrono::high_resolution_clock::now();
-        while (!glfwWindowShouldClose(m_window) && !m_application->NeedsToBeClose()) {
-            glfwPollEvents(); // Process window events
+        const bool pipelined = m_window && m_renderPipelineDepth > 0;
+        if (pipelined) {
+            glfwMakeContextCurrent(nullptr); // The render thread takes the context over
+            RenderThread::Callbacks callbacks;
+            callbacks.attach = [this]() { glfwMakeContextCurrent(m_window); };
+            callbacks.detach = []() { glfwMakeContextCurrent(nullptr); };
+            callbacks.render = [this](const FramePacket &packet) {
+                RenderFrame(packet);
+                glfwSwapBuffers(m_window);
+            };
+            m_renderThread.Start(m_renderPipelineDepth, std::move(callbacks));
+        }
 
-            auto now = std::chrono::high_resolution_clock::now();
-            float deltaTime = std::chrono::duration<float>(now - m_lastTimePoint).count();
-            m_lastTimePoint = now;
+        m_lastTimePoint = std::chrono::steady_clock::now();
+        while (!m_application->NeedsToBeClose() && (m_frameLimit == 0 || m_frameCount < m_frameLimit)) {
+            float deltaTime = m_headlessFrameTime; // Synthetic clock: every frame lasts exactly frameTime
+            if (m_window) {
+                if (glfwWindowShouldClose(m_window)) break;
+                glfwPollEvents(); // Process window events
+            }
+
+            if (m_replaying) {
+                if (m_frameCount >= m_inputRecording.GetFrameCount()) break;
+                deltaTime = m_inputRecording.GetDeltaTime(m_frameCount);
+                m_inputRecording.ApplyFrame(m_frameCount, m_inputManager);
+                if (!m_replayUncapped) {
+                    // Paced: frame n starts once the recorded time of frames 0..n-1 has passed
+                    std::this_thread::sleep_until(m_lastTimePoint);
+                    m_lastTimePoint += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<float>(deltaTime));
+                }
+            }
+            else if (m_window) {
+                auto now = std::chrono::steady_clock::now();
+                deltaTime = std::chrono::duration<float>(now - m_lastTimePoint).count();
+                m_lastTimePoint = now;
+            }
 
-            m_application->Update(deltaTime);
+            if (m_recording) {
+                m_inputRecording.RecordFrame(deltaTime, m_inputManager);
+            }
 
-            m_graphicsAPI.SetColor(LEN::Color::BLACK, 1.0f);
-            m_graphicsAPI.ClearBuffers();
+            const auto frameStart = std::chrono::steady_clock::now();
+            Simulate(deltaTime);
+            m_time += deltaTime;
 
             CameraData cameraData;
 
-            int width(0), height(0);
-            glfwGetWindowSize(m_window, &width, &height);
-            float aspectRatio = static_cast<float>(width) / static_cast<float>(height);
+            int width(m_width), height(m_height);
+            if (m_window) {
+                glfwGetWindowSize(m_window, &width, &height);
+            }
+            float aspectRatio = height > 0 ? static_cast<float>(width) / static_cast<float>(height) : 1.0f;
+            cameraData.viewport = glm::vec4(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
 
             if (m_currentScene) {
                 if (auto cameraObject = m_currentScene->GetMainCamera()) {
                     // Logic for matrices
                     auto cameraComponent = cameraObject->GetComponent<CameraComponent>();
                     if (cameraComponent) {
-                        cameraData.viewMatrix = cameraComponent->GetViewMatrix();
+                        cameraData.viewMatrix = cameraComponent->GetViewMatrix(m_interpolationAlpha);
                         cameraData.projectionMatrix = cameraComponent->GetProjectionMatrix(aspectRatio);
                     }
                 }
             }
-            m_renderQueue.Draw(m_graphicsAPI, cameraData);
+            // Headless still culls and walks the commands, only the GL calls are skipped
+            if (pipelined) {
+                FramePacket &packet = m_renderThread.BeginFrame(); // Blocks while depth frames are queued
+                m_renderQueue.Prepare(packet, cameraData, m_interpolationAlpha);
+                packet.time = m_time;
+                packet.deltaTime = deltaTime;
+                m_renderThread.EndFrame();
+                m_frameTimings.Add(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+            } else {
+                m_framePacket.releases.clear(); // The previous frame has been drawn
+                m_renderQueue.Prepare(m_framePacket, cameraData, m_interpolationAlpha);
+                m_framePacket.time = m_time;
+                m_framePacket.deltaTime = deltaTime;
+                RenderFrame(m_framePacket);
+                m_frameTimings.Add(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+                if (m_window) {
+                    glfwSwapBuffers(m_window); // Swap front and back buffers
+                }
+            }
+            ++m_frameCount;
+        }
+
+        if (pipelined) {
+            m_renderThread.Stop(); // Draws the frames still queued
+            glfwMakeContextCurrent(m_window);
+            m_renderThread.ReleaseFrames();
+        }
 
-            glfwSwapBuffers(m_window); // Swap front and back buffers
+        if (m_recording) {
+            m_inputRecording.Save(m_recordPath);
+            m_recording = false;
         }
+        m_replaying = false;
     }
 
 
+    void Engine::Simulate(float frameTime) {
+        if (!m_fixedTimestep) {
+            m_application->Update(frameTime);
+            if (m_currentScene) {
+                m_currentScene->UpdateTransforms(); // Recompute only transforms changed this frame
+            }
+            m_interpolationAlpha = 1.0f;
+            return;
+        }
+
+        m_accumulator += frameTime;
+        uint32_t substeps = 0;
+        while (m_accumulator >= m_fixedDeltaTime && substeps < m_maxSubsteps) {
+            m_renderQueue.Clear(); // Only the last tick's submissions are drawn
+            m_application->Update(m_fixedDeltaTime);
+            if (m_currentScene) {
+                m_currentScene->UpdateTransforms(); // Also keeps the previous world matrices for interpolation
+            }
+            m_accumulator -= m_fixedDeltaTime;
+            ++substeps;
+        }
+
+        // Spiral-of-death guard: drop what the ticks could not catch up on, but keep the phase
+        if (m_accumulator >= m_fixedDeltaTime) {
+            m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+        }
+        m_interpolationAlpha = m_accumulator / m_fixedDeltaTime;
+    }
+
+    void Engine::RenderFrame(const FramePacket &packet) {
+        m_graphicsAPI.SetColor(LEN::Color::BLACK, 1.0f);
+        m_graphicsAPI.ClearBuffers();
+        RenderQueue::Execute(m_graphicsAPI, packet);
+        m_graphicsAPI.EndFrame();
+    }
+
     void Engine::Destroy() {
         if (m_application) {
             m_application->Destroy();
@@ -145,8 +305,11 @@ namespace LEN {
                 glfwDestroyWindow(m_window);
                 m_window = nullptr;
             }
-            glfwTerminate();
+            if (!m_headless) {
+                glfwTerminate();
+            }
         }
+        m_jobSystem.Shutdown();
     }
 
     void Engine::SetApplication(Application *app) {
@@ -170,6 +333,92 @@ namespace LEN {
         return m_renderQueue;
     }
 
+    JobSystem &Engine::GetJobSystem() {
+        return m_jobSystem;
+    }
+
+    void Engine::SetJobThreadCount(uint32_t threadCount) {
+        m_jobThreadCount = threadCount;
+    }
+
+    void Engine::SetFixedTimestep(bool enabled, float tickRate, uint32_t maxSubsteps) {
+        m_fixedTimestep = enabled;
+        m_fixedDeltaTime = 1.0f / std::max(tickRate, 1.0f);
+        m_maxSubsteps = std::max(maxSubsteps, 1u);
+        m_accumulator = 0.0f;
+        m_interpolationAlpha = 1.0f;
+        m_renderQueue.SetRetainCommands(enabled); // Frames without a tick redraw the last tick's commands
+    }
+
+    bool Engine::IsFixedTimestep() const {
+        return m_fixedTimestep;
+    }
+
+    float Engine::GetFixedDeltaTime() const {
+        return m_fixedDeltaTime;
+    }
+
+    float Engine::GetInterpolationAlpha() const {
+        return m_interpolationAlpha;
+    }
+
+    void Engine::SetHeadless(bool headless, float frameTime) {
+        m_headless = headless;
+        m_headlessFrameTime = std::max(frameTime, 0.0f);
+    }
+
+    bool Engine::IsHeadless() const {
+        return m_headless;
+    }
+
+    void Engine::SetFrameLimit(uint64_t frameCount) {
+        m_frameLimit = frameCount;
+    }
+
+    uint64_t Engine::GetFrameCount() const {
+        return m_frameCount;
+    }
+
+    void Engine::RecordInput(const std::string &path) {
+        m_recordPath = path;
+        m_recording = true;
+        m_replaying = false;
+    }
+
+    bool Engine::ReplayInput(const std::string &path, bool uncapped) {
+        m_recording = false;
+        m_replaying = m_inputRecording.Load(path);
+        m_replayUncapped = uncapped;
+        if (m_replaying) {
+            m_frameTimings.SetEnabled(true);
+        }
+        return m_replaying;
+    }
+
+    bool Engine::IsRecording() const {
+        return m_recording;
+    }
+
+    bool Engine::IsReplaying() const {
+        return m_replaying;
+    }
+
+    FrameTimings &Engine::GetFrameTimings() {
+        return m_frameTimings;
+    }
+
+    void Engine::SetRenderPipelineDepth(uint32_t depth) {
+        m_renderPipelineDepth = depth;
+    }
+
+    uint32_t Engine::GetRenderPipelineDepth() const {
+        return m_renderPipelineDepth;
+    }
+
+    RenderThread &Engine::GetRenderThread() {
+        return m_renderThread;
+    }
+
     void Engine::SetScene(Scene *scene) {
         m_currentScene.reset(scene);
     }
@@ -3,9 +3,14 @@
 #include "graphics/ShaderProgram.hpp"
 #include "Core/graphics/GraphicsAPI.hpp"
 #include "Core/render/RenderQueue.hpp"
+#include "Core/render/RenderThread.hpp"
+#include "Core/jobs/JobSystem.hpp"
 #include "Core/scene/Scene.hpp"
+#include "Core/input/InputRecording.hpp"
+#include "Core/profiling/FrameTimings.hpp"
 #include <memory>
 #include <chrono>
+#include <string>
 
 
 struct GLFWwindow;
@@ -42,18 +47,91 @@ namespace LEN
 
 		GraphicsAPI& GetGraphicsAPI();
         RenderQueue& GetRenderQueue();
+        JobSystem& GetJobSystem();
+
+        // Threads used by the job system, main thread included. 0 = one per core, 1 = deterministic
+        // single-threaded execution. Call before Init.
+        void SetJobThreadCount(uint32_t threadCount);
+
+        // Fixed-step simulation: Application::Update runs tickRate times per second with a constant
+        // deltaTime, at most maxSubsteps times per frame (time beyond that is dropped). Rendering
+        // interpolates between the last two ticks, so the tick rate and frame rate are independent.
+        // Off by default: one variable step per rendered frame.
+        void SetFixedTimestep(bool enabled, float tickRate = 60.0f, uint32_t maxSubsteps = 5);
+        bool IsFixedTimestep() const;
+        float GetFixedDeltaTime() const;
+        float GetInterpolationAlpha() const; // Progress towards the next tick, 0..1; 1 without fixed step
+
+        // Headless: Init creates no window or GL context and Run advances a synthetic clock by
+        // frameTime per frame as fast as it can. Resources are created without GPU objects and the
+        // render queue still culls, so simulation and CPU benchmarks run on machines without a GPU.
+        // Call before Init.
+        void SetHeadless(bool headless, float frameTime = 1.0f / 60.0f);
+        bool IsHeadless() const;
+
+        // Run returns after this many frames, 0 = until the window or application closes
+        void SetFrameLimit(uint64_t frameCount);
+        uint64_t GetFrameCount() const; // Frames run by the current or last Run
+
+        // Record: every frame of the next Run stores its input and deltaTime, written to path when
+        // Run returns. Replay: the next Run ignores the devices and the clock, feeds the recorded
+        // input and deltaTime back frame by frame and returns at the end of the recording.
+        // Uncapped replays run as fast as possible (no vsync, no waiting); paced ones take the
+        // recorded wall time. Replays collect per-frame CPU times in GetFrameTimings.
+        void RecordInput(const std::string& path);
+        bool ReplayInput(const std::string& path, bool uncapped = true);
+        bool IsRecording() const;
+        bool IsReplaying() const;
+        FrameTimings& GetFrameTimings(); // Cleared by every Run, enabled by ReplayInput
+
+        // Frames drawn by the render thread while the main thread simulates the next ones: 1 = double
+        // buffering (default), 2 = triple. 0 draws on the main thread, for debugging. Headless runs
+        // always draw on the main thread. Call before Run.
+        void SetRenderPipelineDepth(uint32_t depth);
+        uint32_t GetRenderPipelineDepth() const;
+        RenderThread& GetRenderThread();
 
         void SetScene(Scene* scene);
         Scene* GetCurrentScene();
 
     private:
+        void Simulate(float frameTime); // Runs the variable step or the fixed ticks due this frame
+        void RenderFrame(const FramePacket& packet); // Clear and draw, on the thread owning the context
+
+        JobSystem m_jobSystem; // Declared first so workers outlive everything that may schedule jobs
+        uint32_t m_jobThreadCount = 0;
+
         std::unique_ptr<Application> m_application;
         std::chrono::steady_clock::time_point m_lastTimePoint;
+
+        bool m_fixedTimestep = false;
+        float m_fixedDeltaTime = 1.0f / 60.0f;
+        uint32_t m_maxSubsteps = 5;
+        float m_accumulator = 0.0f; // Frame time not yet consumed by ticks
+        float m_interpolationAlpha = 1.0f;
+        float m_time = 0.0f; // Sum of the frame deltas of this Run, for FrameUniforms::time
+
+        bool m_headless = false;
+        float m_headlessFrameTime = 1.0f / 60.0f;
+        uint64_t m_frameLimit = 0;
+        uint64_t m_frameCount = 0;
+        InputRecording m_inputRecording;
+        std::string m_recordPath;
+        bool m_recording = false;
+        bool m_replaying = false;
+        bool m_replayUncapped = true;
+        FrameTimings m_frameTimings; // CPU time of Simulate + Draw, swap and pacing excluded
+
+        int m_width = 0; // Size requested from Init, the aspect ratio when there is no window
+        int m_height = 0;
 		GLFWwindow* m_window = nullptr;
 
 		InputManager m_inputManager;
 
 		GraphicsAPI m_graphicsAPI;
+		RenderThread m_renderThread; // Before the queue and scene: their releases may enqueue GL work
+		uint32_t m_renderPipelineDepth = 1;
+		FramePacket m_framePacket; // Drawn on the main thread when not pipelined
 		RenderQueue m_renderQueue;
 
         std::unique_ptr<Scene> m_currentScene;
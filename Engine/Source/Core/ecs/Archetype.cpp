@@ -0,0 +1,166 @@
+#include "Core/ecs/Archetype.hpp"
+#include <algorithm>
+
+namespace LEN
+{
+	Column::Column(const ComponentInfo& info)
+		: m_info(&info)
+	{
+	}
+
+	Column::Column(Column&& other) noexcept
+		: m_info(other.m_info), m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity)
+	{
+		other.m_data = nullptr;
+		other.m_size = 0;
+		other.m_capacity = 0;
+	}
+
+	Column::~Column()
+	{
+		for (size_t row = 0; row < m_size; ++row)
+		{
+			m_info->destroy(Get(row));
+		}
+		if (m_data)
+		{
+			::operator delete(m_data, std::align_val_t(m_info->alignment));
+		}
+	}
+
+	void* Column::Emplace()
+	{
+		if (m_size == m_capacity)
+		{
+			Grow();
+		}
+		return Get(m_size++);
+	}
+
+	void Column::Erase(size_t row)
+	{
+		m_info->destroy(Get(row));
+		FillHole(row);
+	}
+
+	void Column::MoveTo(size_t row, Column& destination)
+	{
+		m_info->relocate(destination.Emplace(), Get(row));
+		FillHole(row);
+	}
+
+	void Column::FillHole(size_t row)
+	{
+		const size_t last = m_size - 1;
+		if (row != last)
+		{
+			m_info->relocate(Get(row), Get(last));
+		}
+		m_size = last;
+	}
+
+	void Column::Grow()
+	{
+		const size_t capacity = std::max<size_t>(16, m_capacity * 2);
+		auto* data = static_cast<std::byte*>(::operator new(capacity * m_info->size, std::align_val_t(m_info->alignment)));
+		for (size_t row = 0; row < m_size; ++row)
+		{
+			m_info->relocate(data + row * m_info->size, Get(row));
+		}
+		if (m_data)
+		{
+			::operator delete(m_data, std::align_val_t(m_info->alignment));
+		}
+		m_data = data;
+		m_capacity = capacity;
+	}
+
+	Archetype::Archetype(std::vector<const ComponentInfo*> infos)
+		: m_infos(std::move(infos))
+	{
+		m_columns.reserve(m_infos.size());
+		for (const ComponentInfo* info : m_infos)
+		{
+			m_columnIndices[info->typeId] = static_cast<int>(m_columns.size());
+			m_signature.push_back(info->typeId);
+			m_columns.emplace_back(*info);
+		}
+	}
+
+	const std::vector<ComponentTypeId>& Archetype::GetSignature() const
+	{
+		return m_signature;
+	}
+
+	int Archetype::GetColumnIndex(ComponentTypeId typeId) const
+	{
+		auto it = m_columnIndices.find(typeId);
+		return it != m_columnIndices.end() ? it->second : -1;
+	}
+
+	Column& Archetype::GetColumn(size_t index)
+	{
+		return m_columns[index];
+	}
+
+	const std::vector<const ComponentInfo*>& Archetype::GetInfos() const
+	{
+		return m_infos;
+	}
+
+	size_t Archetype::GetSize() const
+	{
+		return m_entities.size();
+	}
+
+	const Entity* Archetype::GetEntities() const
+	{
+		return m_entities.data();
+	}
+
+	size_t Archetype::PushEntity(Entity entity)
+	{
+		m_entities.push_back(entity);
+		return m_entities.size() - 1;
+	}
+
+	Entity Archetype::Erase(size_t row)
+	{
+		for (auto& column : m_columns)
+		{
+			column.Erase(row);
+		}
+		return PopHole(row);
+	}
+
+	Entity Archetype::MoveTo(size_t row, Archetype& destination)
+	{
+		for (auto& column : m_columns)
+		{
+			const int target = destination.GetColumnIndex(column.GetInfo().typeId);
+			if (target >= 0)
+			{
+				column.MoveTo(row, destination.m_columns[target]);
+			}
+			else
+			{
+				column.Erase(row);
+			}
+		}
+		destination.PushEntity(m_entities[row]);
+		return PopHole(row);
+	}
+
+	Entity Archetype::PopHole(size_t row)
+	{
+		const size_t last = m_entities.size() - 1;
+		Entity moved;
+		if (row != last)
+		{
+			m_entities[row] = m_entities[last];
+			moved = m_entities[row];
+		}
+		m_entities.pop_back();
+		return moved;
+	}
+}
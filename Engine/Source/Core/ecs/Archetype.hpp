@@ -0,0 +1,124 @@
+#pragma once
+#include "Core/ecs/Entity.hpp"
+#include "Core/scene/Component.hpp"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LEN
+{
+	class Archetype;
+
+	using ComponentTypeId = size_t;
+
+	// Legacy Component subclasses are stored as non-owning pointers (the GameObject keeps ownership),
+	// plain data components are stored by value
+	template<typename T>
+	constexpr bool IsLegacyComponent = std::is_base_of_v<Component, T>;
+
+	template<typename T>
+	using ComponentStorage = std::conditional_t<IsLegacyComponent<T>, Component*, T>;
+
+	// Shares the id space with Component so a legacy component keeps the id it reports from GetTypeId()
+	template<typename T>
+	ComponentTypeId ComponentTypeOf()
+	{
+		return Component::StaticTypeId<T>();
+	}
+
+	// Type-erased description of a column element
+	struct ComponentInfo
+	{
+		ComponentTypeId typeId = 0;
+		size_t size = 0;
+		size_t alignment = 0;
+		void (*relocate)(void* destination, void* source) = nullptr; // Move-constructs into destination and destroys source
+		void (*destroy)(void* element) = nullptr;
+
+		template<typename T>
+		static const ComponentInfo& Of()
+		{
+			using Stored = ComponentStorage<T>;
+			static const ComponentInfo info{
+				ComponentTypeOf<T>(),
+				sizeof(Stored),
+				alignof(Stored),
+				[](void* destination, void* source) {
+					Stored* from = static_cast<Stored*>(source);
+					new (destination) Stored(std::move(*from));
+					from->~Stored();
+				},
+				[](void* element) { static_cast<Stored*>(element)->~Stored(); }
+			};
+			return info;
+		}
+	};
+
+	// Contiguous array of one component type. Rows are removed with swap-and-pop.
+	class Column
+	{
+	public:
+		explicit Column(const ComponentInfo& info);
+		Column(Column&& other) noexcept;
+		Column(const Column&) = delete;
+		Column& operator=(const Column&) = delete;
+		~Column();
+
+		void* Emplace(); // Uninitialized slot at the end, the caller constructs the element
+		void Erase(size_t row);
+		void MoveTo(size_t row, Column& destination); // Relocates row to the end of destination and fills the hole
+
+		void* Get(size_t row) const { return m_data + row * m_info->size; }
+		void* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+		const ComponentInfo& GetInfo() const { return *m_info; }
+
+	private:
+		void Grow();
+		void FillHole(size_t row); // Moves the last element into row and shrinks
+
+		const ComponentInfo* m_info;
+		std::byte* m_data = nullptr;
+		size_t m_size = 0;
+		size_t m_capacity = 0;
+	};
+
+	// All entities sharing one exact set of component types, stored column by column
+	class Archetype
+	{
+	public:
+		explicit Archetype(std::vector<const ComponentInfo*> infos); // Sorted by type id
+
+		const std::vector<ComponentTypeId>& GetSignature() const;
+		int GetColumnIndex(ComponentTypeId typeId) const; // -1 if the archetype lacks the type
+		Column& GetColumn(size_t index);
+		const std::vector<const ComponentInfo*>& GetInfos() const;
+
+		size_t GetSize() const;
+		const Entity* GetEntities() const;
+
+		// Appends an entity whose elements the caller emplaces into every column
+		size_t PushEntity(Entity entity);
+		// Returns the entity that was moved into row to fill the hole, or a null entity
+		Entity Erase(size_t row);
+		// Columns shared with destination are relocated, the rest destroyed. The caller emplaces
+		// the columns destination has in addition. Returns the entity moved into row, if any.
+		Entity MoveTo(size_t row, Archetype& destination);
+
+		// Cached transitions to the archetype with one type added or removed
+		std::unordered_map<ComponentTypeId, Archetype*> addEdges;
+		std::unordered_map<ComponentTypeId, Archetype*> removeEdges;
+
+	private:
+		Entity PopHole(size_t row);
+
+		std::vector<ComponentTypeId> m_signature;
+		std::vector<const ComponentInfo*> m_infos;
+		std::unordered_map<ComponentTypeId, int> m_columnIndices;
+		std::vector<Column> m_columns;
+		std::vector<Entity> m_entities;
+	};
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+namespace LEN
+{
+	// Generational id of an entity in a World. A destroyed entity's id never aliases a new one.
+	struct Entity
+	{
+		uint32_t index = UINT32_MAX; // Slot in the world's entity records
+		uint32_t generation = 0; // Bumped every time the slot is freed
+
+		bool IsNull() const { return index == UINT32_MAX; }
+		bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const Entity& other) const { return !(*this == other); }
+	};
+}
@@ -0,0 +1,250 @@
+#include "Core/ecs/World.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace LEN
+{
+	World::World()
+	{
+		m_emptyArchetype = GetArchetype({});
+	}
+
+	Entity World::CreateEntity()
+	{
+		uint32_t index = 0;
+		if (!m_freeEntities.empty())
+		{
+			index = m_freeEntities.back();
+			m_freeEntities.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(m_records.size());
+			m_records.emplace_back();
+		}
+
+		EntityRecord& record = m_records[index];
+		const Entity entity{ index, record.generation };
+		record.archetype = m_emptyArchetype;
+		record.row = static_cast<uint32_t>(m_emptyArchetype->PushEntity(entity));
+		++m_entityCount;
+		return entity;
+	}
+
+	void World::DestroyEntity(Entity entity)
+	{
+		EntityRecord* record = Find(entity);
+		if (!record)
+		{
+			return;
+		}
+
+		Relink(record->archetype->Erase(record->row), record->row);
+		record->archetype = nullptr;
+		++record->generation;
+		m_freeEntities.push_back(entity.index);
+		--m_entityCount;
+	}
+
+	void World::Clear()
+	{
+		for (uint32_t index = 0; index < m_records.size(); ++index)
+		{
+			if (m_records[index].archetype)
+			{
+				m_records[index].archetype = nullptr;
+				++m_records[index].generation;
+				m_freeEntities.push_back(index);
+			}
+		}
+		m_entityCount = 0;
+
+		m_archetypeList.clear();
+		m_archetypes.clear();
+		m_emptyArchetype = GetArchetype({});
+	}
+
+	bool World::IsAlive(Entity entity) const
+	{
+		return Find(entity) != nullptr;
+	}
+
+	size_t World::GetEntityCount() const
+	{
+		return m_entityCount;
+	}
+
+	void World::Reserve(size_t entityCount)
+	{
+		m_records.reserve(entityCount);
+	}
+
+	void World::Attach(Entity entity, Component* component)
+	{
+		const ComponentTypeId typeId = component->GetTypeId();
+		auto it = m_legacyInfos.find(typeId);
+		if (it == m_legacyInfos.end())
+		{
+			ComponentInfo info = ComponentInfo::Of<Component>();
+			info.typeId = typeId;
+			it = m_legacyInfos.emplace(typeId, info).first;
+		}
+
+		if (GetSlot(entity, typeId))
+		{
+			return;
+		}
+
+		bool replaced = false;
+		void* slot = AddSlot(entity, it->second, replaced);
+		new (slot) Component*(component);
+	}
+
+	void World::Detach(Entity entity, ComponentTypeId typeId)
+	{
+		RemoveSlot(entity, typeId);
+	}
+
+	void* World::AddSlot(Entity entity, const ComponentInfo& info, bool& replaced)
+	{
+		EntityRecord* record = Find(entity);
+		assert(record && "Adding a component to a dead entity");
+
+		Archetype* source = record->archetype;
+		const int existing = source->GetColumnIndex(info.typeId);
+		if (existing >= 0)
+		{
+			replaced = true;
+			return source->GetColumn(existing).Get(record->row);
+		}
+
+		Archetype*& edge = source->addEdges[info.typeId];
+		if (!edge)
+		{
+			std::vector<const ComponentInfo*> infos = source->GetInfos();
+			infos.insert(std::upper_bound(infos.begin(), infos.end(), &info,
+				[](const ComponentInfo* a, const ComponentInfo* b) { return a->typeId < b->typeId; }), &info);
+			edge = GetArchetype(std::move(infos));
+		}
+
+		Archetype* destination = edge;
+		Move(*record, *destination);
+		replaced = false;
+		return destination->GetColumn(destination->GetColumnIndex(info.typeId)).Emplace();
+	}
+
+	void World::RemoveSlot(Entity entity, ComponentTypeId typeId)
+	{
+		EntityRecord* record = Find(entity);
+		if (!record || record->archetype->GetColumnIndex(typeId) < 0)
+		{
+			return;
+		}
+
+		Archetype* source = record->archetype;
+		Archetype*& edge = source->removeEdges[typeId];
+		if (!edge)
+		{
+			std::vector<const ComponentInfo*> infos = source->GetInfos();
+			std::erase_if(infos, [typeId](const ComponentInfo* info) { return info->typeId == typeId; });
+			edge = GetArchetype(std::move(infos));
+		}
+		Move(*record, *edge);
+	}
+
+	void* World::GetSlot(Entity entity, ComponentTypeId typeId) const
+	{
+		const EntityRecord* record = Find(entity);
+		if (!record)
+		{
+			return nullptr;
+		}
+
+		const int column = record->archetype->GetColumnIndex(typeId);
+		return column >= 0 ? record->archetype->GetColumn(column).Get(record->row) : nullptr;
+	}
+
+	World::EntityRecord* World::Find(Entity entity)
+	{
+		if (entity.index >= m_records.size())
+		{
+			return nullptr;
+		}
+		EntityRecord& record = m_records[entity.index];
+		return record.archetype && record.generation == entity.generation ? &record : nullptr;
+	}
+
+	const World::EntityRecord* World::Find(Entity entity) const
+	{
+		return const_cast<World*>(this)->Find(entity);
+	}
+
+	Archetype* World::GetArchetype(std::vector<const ComponentInfo*> infos)
+	{
+		std::vector<ComponentTypeId> signature;
+		for (const ComponentInfo* info : infos)
+		{
+			signature.push_back(info->typeId);
+		}
+
+		auto& archetype = m_archetypes[signature];
+		if (!archetype)
+		{
+			archetype = std::make_unique<Archetype>(std::move(infos));
+			m_archetypeList.push_back(archetype.get());
+		}
+		return archetype.get();
+	}
+
+	void World::Move(EntityRecord& record, Archetype& destination)
+	{
+		Archetype* source = record.archetype;
+		const uint32_t row = record.row;
+		const Entity moved = source->MoveTo(row, destination);
+
+		record.archetype = &destination;
+		record.row = static_cast<uint32_t>(destination.GetSize() - 1);
+		Relink(moved, row);
+	}
+
+	void World::Relink(Entity moved, uint32_t row)
+	{
+		if (!moved.IsNull())
+		{
+			m_records[moved.index].row = row;
+		}
+	}
+
+	std::vector<Archetype*> World::Match(std::initializer_list<ComponentTypeId> typeIds) const
+	{
+		std::vector<Archetype*> matches;
+		for (Archetype* archetype : m_archetypeList)
+		{
+			const bool hasAll = std::all_of(typeIds.begin(), typeIds.end(),
+				[archetype](ComponentTypeId typeId) { return archetype->GetColumnIndex(typeId) >= 0; });
+			if (hasAll)
+			{
+				matches.push_back(archetype);
+			}
+		}
+		return matches;
+	}
+
+	void World::AddSystem(std::unique_ptr<System> system)
+	{
+		m_systems.push_back(std::move(system));
+	}
+
+	void World::UpdateSystems(float deltaTime)
+	{
+		for (auto& system : m_systems)
+		{
+			system->Update(*this, deltaTime);
+		}
+	}
+
+	size_t World::GetArchetypeCount() const
+	{
+		return m_archetypeList.size();
+	}
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include "Core/ecs/Archetype.hpp"
+#include "Core/ecs/Entity.hpp"
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace LEN
+{
+	class World;
+
+	// Runs once per frame over whole columns, see World::View
+	class System
+	{
+	public:
+		virtual ~System() = default;
+		virtual void Update(World& world, float deltaTime) = 0;
+	};
+
+	// Matching archetypes for a set of component types. Structural changes (Create/Destroy/Add/
+	// Remove/Attach) invalidate a view and must not happen while iterating it.
+	template<typename... Ts>
+	class ComponentView
+	{
+	public:
+		explicit ComponentView(std::vector<Archetype*> archetypes)
+			: m_archetypes(std::move(archetypes))
+		{
+		}
+
+		// fn(Ts&...) or fn(Entity, Ts&...) for every matching entity, column by column
+		template<typename Fn>
+		void Each(Fn&& fn) const
+		{
+			EachChunk([&fn](size_t count, const Entity* entities, ComponentStorage<Ts>*... columns) {
+				for (size_t row = 0; row < count; ++row)
+				{
+					if constexpr (std::is_invocable_v<Fn&, Entity, Ts&...>)
+					{
+						fn(entities[row], Element<Ts>(columns[row])...);
+					}
+					else
+					{
+						fn(Element<Ts>(columns[row])...);
+					}
+				}
+			});
+		}
+
+		// fn(count, entities, columns...) once per archetype; legacy components come as Component* columns
+		template<typename Fn>
+		void EachChunk(Fn&& fn) const
+		{
+			for (Archetype* archetype : m_archetypes)
+			{
+				if (archetype->GetSize() > 0)
+				{
+					fn(archetype->GetSize(), archetype->GetEntities(),
+						static_cast<ComponentStorage<Ts>*>(archetype->GetColumn(archetype->GetColumnIndex(ComponentTypeOf<Ts>())).GetData())...);
+				}
+			}
+		}
+
+		size_t GetSize() const
+		{
+			size_t size = 0;
+			for (Archetype* archetype : m_archetypes)
+			{
+				size += archetype->GetSize();
+			}
+			return size;
+		}
+
+	private:
+		template<typename T>
+		static T& Element(ComponentStorage<T>& stored)
+		{
+			if constexpr (IsLegacyComponent<T>)
+			{
+				return static_cast<T&>(*stored);
+			}
+			else
+			{
+				return stored;
+			}
+		}
+
+		std::vector<Archetype*> m_archetypes;
+	};
+
+	// Archetype based entity storage. Entities with the same set of component types share an
+	// archetype whose components live in contiguous per-type columns, so a view walks memory
+	// linearly without a virtual call per entity.
+	// Existing Component subclasses take part through Attach: the column stores a pointer and the
+	// GameObject keeps ownership and keeps calling Component::Update.
+	// Not thread-safe for structural changes; concurrent reads and element writes are fine.
+	class World
+	{
+	public:
+		World();
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		Entity CreateEntity();
+		void DestroyEntity(Entity entity);
+		bool IsAlive(Entity entity) const;
+		size_t GetEntityCount() const;
+		void Reserve(size_t entityCount);
+		void Clear(); // Destroys every entity and archetype; systems stay registered
+
+		// Adds (or replaces) a data component and moves the entity to the matching archetype
+		template<typename T, typename... Args>
+		T& Add(Entity entity, Args&&... args)
+		{
+			static_assert(!IsLegacyComponent<T>, "Component subclasses are attached with Attach");
+			bool replaced = false;
+			void* slot = AddSlot(entity, ComponentInfo::Of<T>(), replaced);
+			if (replaced)
+			{
+				static_cast<T*>(slot)->~T();
+			}
+			return *new (slot) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		void Remove(Entity entity)
+		{
+			RemoveSlot(entity, ComponentTypeOf<T>());
+		}
+
+		// Adapter for legacy components: stores a non-owning pointer under component->GetTypeId().
+		// Attaching a second component of a type already present keeps the first one.
+		void Attach(Entity entity, Component* component);
+		void Detach(Entity entity, ComponentTypeId typeId);
+
+		template<typename T>
+		T* Get(Entity entity) const
+		{
+			void* slot = GetSlot(entity, ComponentTypeOf<T>());
+			if (!slot)
+			{
+				return nullptr;
+			}
+			if constexpr (IsLegacyComponent<T>)
+			{
+				return static_cast<T*>(*static_cast<Component**>(slot));
+			}
+			else
+			{
+				return static_cast<T*>(slot);
+			}
+		}
+
+		template<typename T>
+		bool Has(Entity entity) const
+		{
+			return GetSlot(entity, ComponentTypeOf<T>()) != nullptr;
+		}
+
+		template<typename... Ts>
+		ComponentView<Ts...> View() const
+		{
+			return ComponentView<Ts...>(Match({ ComponentTypeOf<Ts>()... }));
+		}
+
+		void AddSystem(std::unique_ptr<System> system);
+		void UpdateSystems(float deltaTime); // Runs systems in registration order
+
+		size_t GetArchetypeCount() const;
+
+	private:
+		struct EntityRecord
+		{
+			uint32_t generation = 0;
+			Archetype* archetype = nullptr; // nullptr while the slot is free
+			uint32_t row = 0;
+		};
+
+		void* AddSlot(Entity entity, const ComponentInfo& info, bool& replaced);
+		void RemoveSlot(Entity entity, ComponentTypeId typeId);
+		void* GetSlot(Entity entity, ComponentTypeId typeId) const;
+		EntityRecord* Find(Entity entity);
+		const EntityRecord* Find(Entity entity) const;
+		Archetype* GetArchetype(std::vector<const ComponentInfo*> infos);
+		void Move(EntityRecord& record, Archetype& destination);
+		void Relink(Entity moved, uint32_t row); // Fixes the record of the entity a swap-and-pop moved
+		std::vector<Archetype*> Match(std::initializer_list<ComponentTypeId> typeIds) const;
+
+		std::vector<EntityRecord> m_records;
+		std::vector<uint32_t> m_freeEntities;
+		size_t m_entityCount = 0;
+
+		std::unordered_map<ComponentTypeId, ComponentInfo> m_legacyInfos; // Pointer columns; stable nodes, outlive the archetypes
+		std::map<std::vector<ComponentTypeId>, std::unique_ptr<Archetype>> m_archetypes;
+		std::vector<Archetype*> m_archetypeList; // Creation order, keeps view iteration deterministic
+		Archetype* m_emptyArchetype = nullptr;
+
+		std::vector<std::unique_ptr<System>> m_systems;
+	};
+}
@@ -3,15 +3,41 @@
 #include "Application.hpp"
 #include "Engine.hpp"
 #include "Core/input/InputManager.hpp"
+#include "Core/input/InputRecording.hpp"
+#include "Core/profiling/FrameTimings.hpp"
+#include "Core/jobs/JobSystem.hpp"
+#include "Core/memory/SlabPool.hpp"
+#include "Core/memory/RangeAllocator.hpp"
+#include "Core/io/MappedFile.hpp"
+#include "Core/strings/StringId.hpp"
+#include "Core/spatial/AABB.hpp"
+#include "Core/spatial/BoundingSphere.hpp"
+#include "Core/spatial/Frustum.hpp"
+#include "Core/spatial/DynamicBVH.hpp"
 #include "Core/graphics/ShaderProgram.hpp"
+#include "Core/graphics/ShaderReflection.hpp"
 #include "Core/graphics/GraphicsAPI.hpp"
+#include "Core/graphics/StreamBuffer.hpp"
+#include "Core/graphics/FrameUniforms.hpp"
 #include "Core/render/VertexLayout.hpp"
+#include "Core/render/VertexCompression.hpp"
 #include "Core/render/Material.hpp"
+#include "Core/render/MaterialLayout.hpp"
 #include "Core/render/Mesh.hpp"
 #include "Core/render/RenderQueue.hpp"
+#include "Core/render/RenderCommandBuffer.hpp"
+#include "Core/render/GeometryPool.hpp"
+#include "Core/render/RenderThread.hpp"
+#include "Core/render/RenderSort.hpp"
+#include "Core/render/FrustumCuller.hpp"
 #include "Core/graphics/Colors.hpp"
 #include "Core/scene/Scene.hpp"
 #include "Core/scene/GameObject.hpp"
+#include "Core/scene/TransformStore.hpp"
+#include "Core/scene/ObjectHandle.hpp"
+#include "Core/scene/SceneSerializer.hpp"
+#include "Core/ecs/Entity.hpp"
+#include "Core/ecs/World.hpp"
 #include "Core/scene/Component.hpp"
 #include "Core/scene/components/MeshComponent.hpp"
 #include "Core/scene/components/CameraComponent.hpp"
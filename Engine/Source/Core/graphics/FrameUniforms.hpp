@@ -0,0 +1,39 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+namespace LEN
+{
+	// Per-frame shader data, uploaded once per frame into a std140 uniform buffer bound at
+	// FrameUniformsBinding. Shaders get the block by putting the include line below their #version:
+	//     #include <LEN/FrameUniforms.glsl>
+	// GraphicsAPI::CreateShaderProgram expands it to FrameUniformsGlsl and binds the block.
+	constexpr GLuint FrameUniformsBinding = 0;
+	constexpr const char* FrameUniformsBlock = "FrameUniforms";
+	constexpr const char* FrameUniformsInclude = "#include <LEN/FrameUniforms.glsl>";
+
+	constexpr const char* FrameUniformsGlsl = R"(layout (std140) uniform FrameUniforms
+{
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+    vec4 uViewport;   // x, y, width, height in pixels
+    float uTime;      // Seconds since Run started, simulated time
+    float uDeltaTime;
+};
+)";
+
+	// Mirrors the std140 layout of FrameUniformsGlsl member by member
+	struct FrameUniforms
+	{
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::mat4 viewProjection = glm::mat4(1.0f);
+		glm::vec4 viewport = glm::vec4(0.0f);
+		float time = 0.0f;
+		float deltaTime = 0.0f;
+		float padding[2] = {}; // std140 rounds the block up to 16 bytes
+	};
+	static_assert(sizeof(FrameUniforms) == 224, "FrameUniforms must match the std140 block");
+}
\ No newline at end of file
@@ -1,15 +1,92 @@
 #include "Core/graphics/GraphicsAPI.hpp"
 #include "Core/graphics/ShaderProgram.hpp"
+#include "Core/graphics/ShaderReflection.hpp"
 #include "Core/render/Material.hpp"
 #include "Core/render/Mesh.hpp"
+#include "Core/render/GeometryPool.hpp"
+#include "Core/render/RenderThread.hpp"
+#include "Core/render/RenderCommandBuffer.hpp"
+#include <algorithm>
 #include <iostream>
 
 
 
 namespace LEN
 {
+	namespace
+	{
+		// GLSL 330 has no #include; engine include lines are replaced by the text they name
+		std::string ExpandEngineIncludes(const std::string& source)
+		{
+			std::string expanded = source;
+			const std::string include = FrameUniformsInclude;
+			for (size_t at = expanded.find(include); at != std::string::npos; at = expanded.find(include, at))
+			{
+				expanded.replace(at, include.size(), FrameUniformsGlsl);
+				at += std::char_traits<char>::length(FrameUniformsGlsl);
+			}
+			return expanded;
+		}
+	}
+
+	GraphicsAPI::GraphicsAPI()
+	{
+		InvalidateStateCache();
+	}
+
+	GraphicsAPI::~GraphicsAPI() = default;
+
+	void GraphicsAPI::SetHeadless(bool headless)
+	{
+		m_headless = headless;
+	}
+
+	bool GraphicsAPI::IsHeadless() const
+	{
+		return m_headless;
+	}
+
+	void GraphicsAPI::SetRenderThread(RenderThread* renderThread)
+	{
+		m_renderThread = renderThread;
+	}
+
+	void GraphicsAPI::RunOnContext(const std::function<void()>& work)
+	{
+		if (m_renderThread)
+		{
+			m_renderThread->Execute(work); // Inline when it is not running or when called on it
+			return;
+		}
+		work();
+	}
+
+	void GraphicsAPI::ReleaseOnContext(std::function<void()> work)
+	{
+		if (m_renderThread)
+		{
+			m_renderThread->Enqueue(std::move(work));
+			return;
+		}
+		work();
+	}
+
 	std::shared_ptr<ShaderProgram> LEN::GraphicsAPI::CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource) 
 	{
+        if (m_headless) {
+            return std::make_shared<ShaderProgram>(0); // Program without a GL object, uniforms are ignored
+        }
+
+        const std::string vertexExpanded = ExpandEngineIncludes(vertexSource);
+        const std::string fragmentExpanded = ExpandEngineIncludes(fragmentSource);
+        std::shared_ptr<ShaderProgram> program;
+        RunOnContext([&]() { program = CompileShaderProgram(vertexExpanded, fragmentExpanded); });
+        return program;
+    }
+
+	std::shared_ptr<ShaderProgram> GraphicsAPI::CompileShaderProgram(const std::string& vertexSource, const std::string& fragmentSource)
+	{
+
         GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
         const char* vertexShaderCStr = vertexSource.c_str();
         glShaderSource(vertexShader, 1, &vertexShaderCStr, nullptr);
@@ -68,27 +145,42 @@ namespace LEN
 
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
-		return std::make_shared<ShaderProgram>(shaderProgramID); // Return the created ShaderProgram
+
+        // Active uniforms, attributes and blocks, queried once; the program validates against them
+        ShaderReflection reflection = ShaderReflection::Reflect(shaderProgramID);
+		return std::make_shared<ShaderProgram>(shaderProgramID, std::move(reflection)); // Return the created ShaderProgram
     
     }
 
     GLuint GraphicsAPI::CreateVertexBuffer(const std::vector<float>& vertices)
     {
         GLuint VBO = 0;
-        glGenBuffers(1, &VBO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (m_headless) {
+            return VBO;
+        }
+        RunOnContext([&]() {
+            glGenBuffers(1, &VBO);
+            BindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+            BindBuffer(GL_ARRAY_BUFFER, 0);
+        });
 		return VBO;
     }
 
     GLuint GraphicsAPI::CreateIndexBuffer(const std::vector<uint32_t>& indices)
     {
         GLuint EBO = 0;
-        glGenBuffers(1, &EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        if (m_headless) {
+            return EBO;
+        }
+        RunOnContext([&]() {
+            glGenBuffers(1, &EBO);
+            // Element buffer bindings belong to the bound VAO, keep the upload from changing one
+            BindVertexArray(0);
+            BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+            BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        });
         return EBO;
     }
 
@@ -100,11 +192,11 @@ namespace LEN
         }
     }
 
-    void GraphicsAPI::BindMaterial(Material* material)
+    void GraphicsAPI::BindMaterial(const MaterialSnapshot& snapshot, const std::byte* values, const GLuint* textures)
     {
-        if (material)
+        if (snapshot.material)
         {
-			material->Bind();
+			snapshot.material->Bind(snapshot, values, textures);
         }
     }
 
@@ -124,16 +216,360 @@ namespace LEN
         }
     }
 
+    void GraphicsAPI::DrawMeshInstanced(Mesh* mesh, GLuint instanceBuffer, size_t offset, uint32_t instanceCount)
+    {
+        if (mesh)
+        {
+            mesh->BindInstanceBuffer(instanceBuffer, offset);
+            mesh->DrawInstanced(instanceCount);
+        }
+    }
+
+    GeometryPool* GraphicsAPI::GetGeometryPool(const VertexLayout& layout)
+    {
+        if (m_headless) {
+            return nullptr;
+        }
+        for (auto& pool : m_geometryPools) {
+            if (pool->GetLayout() == layout) {
+                return pool.get();
+            }
+        }
+        m_geometryPools.push_back(std::make_unique<GeometryPool>(*this, layout));
+        return m_geometryPools.back().get();
+    }
+
+    bool GraphicsAPI::SupportsMultiDrawIndirect() const
+    {
+        if (m_headless) {
+            return false;
+        }
+        return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+    }
+
+    void GraphicsAPI::DrawMultiIndirect(GeometryPool* pool, const DrawElementsIndirectCommand* commands, uint32_t count,
+        GLuint instanceBuffer, size_t instanceOffset)
+    {
+        if (m_headless || !pool || count == 0) {
+            return;
+        }
+
+        StreamBuffer::Allocation allocation;
+        if (SupportsMultiDrawIndirect()) {
+            allocation = GetStreamBuffer()->Write(commands, count * sizeof(DrawElementsIndirectCommand), sizeof(uint32_t));
+        }
+        if (!allocation.IsValid()) {
+            // Base vertex draws; baseInstance becomes an offset into the instance buffer instead
+            pool->Bind();
+            for (uint32_t i = 0; i < count; ++i) {
+                const DrawElementsIndirectCommand& command = commands[i];
+                pool->BindInstanceBuffer(instanceBuffer, instanceOffset + command.baseInstance * sizeof(glm::mat4));
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                    reinterpret_cast<const void*>(static_cast<uintptr_t>(command.firstIndex) * sizeof(uint32_t)),
+                    static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+                CountDrawCall(command.instanceCount);
+            }
+            return;
+        }
+
+        pool->BindInstanceBuffer(instanceBuffer, instanceOffset);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, allocation.buffer);
+        pool->MultiDrawIndirect(allocation.offset, count);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        uint32_t instances = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            instances += commands[i].instanceCount;
+        }
+        m_stats.streamBytes += static_cast<uint32_t>(allocation.size);
+        ++m_stats.multiDraws;
+        CountDrawCall(instances);
+    }
+
+    void GraphicsAPI::UseProgram(GLuint programID)
+    {
+        if (m_headless) {
+            return;
+        }
+        if (programID == m_boundProgram) {
+            ++m_stats.programBindsSkipped;
+            return;
+        }
+        glUseProgram(programID);
+        m_boundProgram = programID;
+        ++m_stats.programBinds;
+    }
+
+    void GraphicsAPI::BindVertexArray(GLuint vertexArrayID)
+    {
+        if (m_headless) {
+            return;
+        }
+        if (vertexArrayID == m_boundVertexArray) {
+            ++m_stats.vertexArrayBindsSkipped;
+            return;
+        }
+        glBindVertexArray(vertexArrayID);
+        m_boundVertexArray = vertexArrayID;
+        m_boundElementBuffer = UnknownBinding;
+        ++m_stats.vertexArrayBinds;
+    }
+
+    void GraphicsAPI::BindBuffer(GLenum target, GLuint bufferID)
+    {
+        if (m_headless) {
+            return;
+        }
+        GLuint* bound = nullptr;
+        if (target == GL_ARRAY_BUFFER) {
+            bound = &m_boundArrayBuffer;
+        }
+        else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+            bound = &m_boundElementBuffer;
+        }
+
+        if (bound && *bound == bufferID) {
+            ++m_stats.bufferBindsSkipped;
+            return;
+        }
+        glBindBuffer(target, bufferID);
+        if (bound) {
+            *bound = bufferID;
+        }
+        ++m_stats.bufferBinds;
+    }
+
+    void GraphicsAPI::BindUniformBuffer(GLuint binding, GLuint bufferID)
+    {
+        if (m_headless) {
+            return;
+        }
+        if (binding < m_boundUniformBuffers.size() && m_boundUniformBuffers[binding] == bufferID) {
+            ++m_stats.bufferBindsSkipped;
+            return;
+        }
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, bufferID);
+        if (binding < m_boundUniformBuffers.size()) {
+            m_boundUniformBuffers[binding] = bufferID;
+        }
+        ++m_stats.bufferBinds;
+    }
+
+    void GraphicsAPI::BindUniformBufferRange(GLuint binding, GLuint bufferID, size_t offset, size_t size)
+    {
+        if (m_headless) {
+            return;
+        }
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, bufferID, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        // The cache holds whole-buffer bindings only; the next BindUniformBuffer is issued
+        if (binding < m_boundUniformBuffers.size()) {
+            m_boundUniformBuffers[binding] = UnknownBinding;
+        }
+        ++m_stats.bufferBinds;
+    }
+
+    void GraphicsAPI::BindTexture(GLuint unit, GLenum target, GLuint textureID)
+    {
+        if (m_headless) {
+            return;
+        }
+        // Units hold one texture per target; the cache assumes each unit is used with one target
+        if (unit < m_boundTextures.size() && m_boundTextures[unit] == textureID) {
+            ++m_stats.textureBindsSkipped;
+            return;
+        }
+        if (unit != m_activeTextureUnit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            m_activeTextureUnit = unit;
+        }
+        glBindTexture(target, textureID);
+        if (unit < m_boundTextures.size()) {
+            m_boundTextures[unit] = textureID;
+        }
+        ++m_stats.textureBinds;
+    }
+
+    void GraphicsAPI::InvalidateStateCache()
+    {
+        m_boundUniformBuffers.fill(UnknownBinding);
+        m_boundTextures.fill(UnknownBinding);
+        m_activeTextureUnit = UnknownBinding;
+        m_viewport = { -1, -1, -1, -1 };
+        m_boundProgram = UnknownBinding;
+        m_boundVertexArray = UnknownBinding;
+        m_boundArrayBuffer = UnknownBinding;
+        m_boundElementBuffer = UnknownBinding;
+    }
+
+    void GraphicsAPI::CountUniformUpload(bool skipped)
+    {
+        if (skipped) {
+            ++m_stats.uniformUploadsSkipped;
+        }
+        else {
+            ++m_stats.uniformUploads;
+        }
+    }
+
+    void GraphicsAPI::CountDrawCall(uint32_t instanceCount)
+    {
+        ++m_stats.drawCalls;
+        m_stats.instances += instanceCount;
+    }
+
+    StreamBuffer* GraphicsAPI::GetStreamBuffer()
+    {
+        if (m_headless) {
+            return nullptr;
+        }
+        if (!m_streamBuffer.IsCreated()) {
+            m_streamBuffer.Create(StreamBufferSize);
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_uniformOffsetAlignment);
+        }
+        return &m_streamBuffer;
+    }
+
+    GLuint GraphicsAPI::UploadInstanceData(const void* data, size_t size, size_t& offset)
+    {
+        offset = 0;
+        if (m_headless) {
+            return 0;
+        }
+        if (size <= StreamBufferSize) {
+            const StreamBuffer::Allocation allocation = GetStreamBuffer()->Write(data, size, sizeof(float) * 4);
+            if (allocation.IsValid()) {
+                m_stats.streamBytes += static_cast<uint32_t>(size);
+                offset = allocation.offset;
+                return allocation.buffer;
+            }
+        }
+
+        if (m_instanceBuffer == 0) {
+            glGenBuffers(1, &m_instanceBuffer);
+        }
+
+        BindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        if (size > m_instanceBufferCapacity) {
+            m_instanceBufferCapacity = std::max(size, m_instanceBufferCapacity * 2);
+        }
+        // Orphan: the driver hands out fresh storage instead of waiting for draws still reading it
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_instanceBufferCapacity), nullptr, GL_STREAM_DRAW);
+        if (size > 0) {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+        }
+        return m_instanceBuffer;
+    }
+
+    void GraphicsAPI::UpdateFrameUniforms(const FrameUniforms& uniforms)
+    {
+        if (m_headless) {
+            return;
+        }
+        // The binding point is context state: every program's block reads from it
+        StreamBuffer* streamBuffer = GetStreamBuffer();
+        const StreamBuffer::Allocation allocation = streamBuffer->Write(&uniforms, sizeof(FrameUniforms),
+            static_cast<size_t>(std::max(m_uniformOffsetAlignment, GLint(16))));
+        if (allocation.IsValid()) {
+            m_stats.streamBytes += static_cast<uint32_t>(sizeof(FrameUniforms));
+            ++m_stats.uniformUploads;
+            BindUniformBufferRange(FrameUniformsBinding, allocation.buffer, allocation.offset, allocation.size);
+            return;
+        }
+        UploadUniformBuffer(m_frameUniformBuffer, m_frameUniformBufferSize, &uniforms, sizeof(FrameUniforms));
+        BindUniformBuffer(FrameUniformsBinding, m_frameUniformBuffer);
+    }
+
+    void GraphicsAPI::UploadUniformBuffer(GLuint& bufferID, size_t& bufferSize, const void* data, size_t size)
+    {
+        if (m_headless) {
+            return;
+        }
+        if (bufferID == 0) {
+            glGenBuffers(1, &bufferID);
+        }
+        if (bufferSize != size) {
+            // First upload or a different block layout (e.g. a new program): sub-data would overrun
+            glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+            glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), data, GL_DYNAMIC_DRAW);
+            bufferSize = size;
+        }
+        else {
+            glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+        }
+        ++m_stats.uniformUploads;
+    }
+
+    void GraphicsAPI::EndFrame()
+    {
+        m_streamBuffer.EndFrame(); // Fences the frame's draws; no-op before the buffer is created
+        std::lock_guard<std::mutex> lock(m_frameStatsMutex);
+        m_frameStats = m_stats;
+        m_stats = StateStats();
+    }
+
+    GraphicsAPI::StateStats GraphicsAPI::GetFrameStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_frameStatsMutex);
+        return m_frameStats;
+    }
+
     void GraphicsAPI::SetColor(Color color, float a)
     {
-       
+        if (m_headless) {
+            return;
+        }
         const ColorRGB c = LEN::GetColorRGB(color);
         glClearColor(c.r, c.g, c.b, a);
     }
 
     void GraphicsAPI::ClearBuffers()
     {
+        if (m_headless) {
+            return;
+        }
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
+    void GraphicsAPI::SetViewport(int32_t x, int32_t y, int32_t width, int32_t height)
+    {
+        if (m_headless) {
+            return;
+        }
+        const std::array<int32_t, 4> viewport = { x, y, width, height };
+        if (viewport == m_viewport) {
+            return;
+        }
+        glViewport(x, y, width, height);
+        m_viewport = viewport;
+    }
+
+    void GraphicsAPI::ApplyStateCommand(const StateCommand& command)
+    {
+        if (m_headless) {
+            return;
+        }
+        switch (command.type)
+        {
+        case StateCommand::Type::Viewport:
+            SetViewport(command.viewport[0], command.viewport[1], command.viewport[2], command.viewport[3]);
+            break;
+        case StateCommand::Type::Clear:
+        {
+            GLbitfield mask = 0;
+            if (command.clearColor) {
+                glClearColor(command.color[0], command.color[1], command.color[2], command.color[3]);
+                mask |= GL_COLOR_BUFFER_BIT;
+            }
+            if (command.clearDepth) {
+                mask |= GL_DEPTH_BUFFER_BIT;
+            }
+            if (mask != 0) {
+                glClear(mask);
+            }
+            break;
+        }
+        }
+    }
+
 }
@@ -3,17 +3,64 @@
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <array>
+#include <functional>
+#include <mutex>
 #include "Core/graphics/Colors.hpp"
+#include "Core/graphics/FrameUniforms.hpp"
+#include "Core/graphics/StreamBuffer.hpp"
 
 namespace LEN
 {
 	class ShaderProgram;
 	class Material;
+	struct MaterialSnapshot;
 	class Mesh;
+	class RenderThread;
+	class GeometryPool;
+	struct VertexLayout;
+	struct DrawElementsIndirectCommand;
+	struct StateCommand;
 
 	class GraphicsAPI
 	{
 	public:
+		GraphicsAPI();
+		~GraphicsAPI();
+
+		// Calls issued to GL versus skipped by the state cache, per frame
+		struct StateStats
+		{
+			uint32_t programBinds = 0;
+			uint32_t programBindsSkipped = 0;
+			uint32_t vertexArrayBinds = 0;
+			uint32_t vertexArrayBindsSkipped = 0;
+			uint32_t bufferBinds = 0;
+			uint32_t bufferBindsSkipped = 0;
+			uint32_t textureBinds = 0;
+			uint32_t textureBindsSkipped = 0;
+			uint32_t uniformUploads = 0;
+			uint32_t uniformUploadsSkipped = 0;
+			uint32_t drawCalls = 0;
+			uint32_t instances = 0; // Objects drawn by those calls
+			uint32_t multiDraws = 0; // Draw calls that were one glMultiDrawElementsIndirect
+			uint32_t streamBytes = 0; // Written to the stream buffer
+		};
+
+		static constexpr size_t StreamBufferSize = 8 * 1024 * 1024; // Bytes, shared by all frames in flight
+
+		// Headless: no GL context exists. Resource creation returns 0 ids and bind/draw/clear calls
+		// do nothing, so meshes, materials and the render queue still run their CPU side.
+		void SetHeadless(bool headless);
+		bool IsHeadless() const;
+
+		// While the render thread runs it owns the GL context. Resource creation and release from
+		// other threads go through these two: inline without a render thread, marshalled otherwise.
+		void SetRenderThread(RenderThread* renderThread);
+		void RunOnContext(const std::function<void()>& work); // Waits for work to finish
+		void ReleaseOnContext(std::function<void()> work); // After the frames already submitted, does not wait
+
+		// Sources may include engine blocks below their #version, see FrameUniforms
 		std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, 
 			const std::string& fragmentSource); 
 		GLuint CreateVertexBuffer(const std::vector<float>& vertices);
@@ -21,12 +68,86 @@ namespace LEN
 
 		void SetColor(Color color, float a = 1.0f);
 		void ClearBuffers();
+		void SetViewport(int32_t x, int32_t y, int32_t width, int32_t height); // Skipped when unchanged
+		void ApplyStateCommand(const StateCommand& command); // Recorded through RenderCommandBuffer
 
 		void BindShaderProgram(ShaderProgram* shderProgram);
-		void BindMaterial(Material* material);
+		void BindMaterial(const MaterialSnapshot& snapshot, const std::byte* values, const GLuint* textures);
 		void BindMesh(Mesh* mesh);
 		void DrawMesh(Mesh* mesh);
+		// Draws instanceCount instances of the bound mesh, their attributes read from instanceBuffer + offset
+		void DrawMeshInstanced(Mesh* mesh, GLuint instanceBuffer, size_t offset, uint32_t instanceCount);
+
+		// Shared buffers of every mesh with this layout, created on first use; on the context thread,
+		// nullptr when headless
+		GeometryPool* GetGeometryPool(const VertexLayout& layout);
+		// glMultiDrawElementsIndirect with per-command base instances (GL 4.3 or the ARB extensions)
+		bool SupportsMultiDrawIndirect() const;
+		// One call for a run of meshes from pool; commands go through the stream buffer and their
+		// baseInstance counts from instanceBuffer + instanceOffset. Falls back to one base vertex
+		// draw per command without multi-draw support.
+		void DrawMultiIndirect(GeometryPool* pool, const DrawElementsIndirectCommand* commands, uint32_t count,
+			GLuint instanceBuffer, size_t instanceOffset);
+		// Context thread scratch for building DrawMultiIndirect runs; callers clear() it, the
+		// capacity is kept across frames
+		std::vector<DrawElementsIndirectCommand>& GetIndirectScratch() { return m_indirectScratch; }
+
+		// State cached binds: the GL call is skipped when the object is already bound. Only on the
+		// thread owning the context; every bind of programs, VAOs and buffers must go through these.
+		void UseProgram(GLuint programID);
+		void BindVertexArray(GLuint vertexArrayID); // Also forgets the element buffer, which is VAO state
+		void BindBuffer(GLenum target, GLuint bufferID); // Cached for GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER
+		void BindUniformBuffer(GLuint binding, GLuint bufferID); // Whole buffer at an indexed binding point
+		void BindUniformBufferRange(GLuint binding, GLuint bufferID, size_t offset, size_t size); // Not cached
+		void BindTexture(GLuint unit, GLenum target, GLuint textureID);
+		void InvalidateStateCache(); // After GL calls made around the cache, the next binds are issued
+		void CountUniformUpload(bool skipped); // ShaderProgram keeps the uniform values, see SetUniform
+		void CountDrawCall(uint32_t instanceCount = 1);
+
+		// Per-frame data ring, see StreamBuffer; created on first use, nullptr when headless.
+		// On the context thread, allocations are valid for the current frame only.
+		StreamBuffer* GetStreamBuffer();
+		// Writes the frame's instance data to the stream buffer and returns the buffer holding it at
+		// offset; on the context thread. Data larger than the ring goes to an orphaned buffer instead.
+		GLuint UploadInstanceData(const void* data, size_t size, size_t& offset);
+
+		// Writes the frame uniform buffer, bound at FrameUniformsBinding for every program; once per
+		// frame on the context thread
+		void UpdateFrameUniforms(const FrameUniforms& uniforms);
+		// Creates bufferID on first use and replaces its contents; on the context thread. bufferSize is
+		// the size bufferID was allocated with, the buffer is reallocated when size differs from it.
+		void UploadUniformBuffer(GLuint& bufferID, size_t& bufferSize, const void* data, size_t size);
+
+		// Closes the frame's counters on the context thread; GetFrameStats returns the last closed frame
+		void EndFrame();
+		StateStats GetFrameStats() const;
+
+	private:
+		std::shared_ptr<ShaderProgram> CompileShaderProgram(const std::string& vertexSource,
+			const std::string& fragmentSource); // On the context thread
 
+		bool m_headless = false;
+		RenderThread* m_renderThread = nullptr;
 
+		static constexpr GLuint UnknownBinding = ~GLuint(0); // Forces the next bind through
+		GLuint m_boundProgram = UnknownBinding;
+		GLuint m_boundVertexArray = UnknownBinding;
+		GLuint m_boundArrayBuffer = UnknownBinding;
+		GLuint m_boundElementBuffer = UnknownBinding;
+		std::array<GLuint, 16> m_boundUniformBuffers; // By binding point, filled with UnknownBinding
+		std::array<GLuint, 32> m_boundTextures; // By texture unit
+		GLuint m_activeTextureUnit = UnknownBinding;
+		std::array<int32_t, 4> m_viewport = { -1, -1, -1, -1 };
+		StreamBuffer m_streamBuffer;
+		std::vector<std::unique_ptr<GeometryPool>> m_geometryPools; // Never released, meshes keep pointers
+		GLint m_uniformOffsetAlignment = 0; // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+		GLuint m_instanceBuffer = 0; // Fallback for instance data larger than the stream buffer
+		size_t m_instanceBufferCapacity = 0; // Bytes
+		GLuint m_frameUniformBuffer = 0; // Fallback when the stream buffer is full
+		size_t m_frameUniformBufferSize = 0;
+		std::vector<DrawElementsIndirectCommand> m_indirectScratch;
+		StateStats m_stats; // Current frame, context thread only
+		StateStats m_frameStats; // Last closed frame
+		mutable std::mutex m_frameStatsMutex;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <GL/glew.h>
+
+// LEN_HEADLESS_ONLY builds link no GL library and no GLEW. These definitions satisfy the GL and
+// GLEW symbols the engine references. Such builds always run headless and never create a context,
+// so none of them is called: GraphicsAPI, ShaderProgram and Mesh return before touching GL.
+// A new GL call in the engine needs its entry point added here.
+#ifdef LEN_HEADLESS_ONLY
+extern "C"
+{
+	// GL 1.1, exported by the GL library itself
+	void GLAPIENTRY glBindTexture(GLenum, GLuint) {}
+	void GLAPIENTRY glClear(GLbitfield) {}
+	void GLAPIENTRY glClearColor(GLclampf, GLclampf, GLclampf, GLclampf) {}
+	void GLAPIENTRY glDrawArrays(GLenum, GLint, GLsizei) {}
+	void GLAPIENTRY glGetIntegerv(GLenum, GLint* params) { *params = 0; }
+	void GLAPIENTRY glViewport(GLint, GLint, GLsizei, GLsizei) {}
+
+	// Extension flags and entry points, loaded by glewInit in windowed builds
+	GLboolean __GLEW_VERSION_4_3 = GL_FALSE;
+	GLboolean __GLEW_ARB_base_instance = GL_FALSE;
+	GLboolean __GLEW_ARB_buffer_storage = GL_FALSE;
+	GLboolean __GLEW_ARB_multi_draw_indirect = GL_FALSE;
+
+	decltype(__glewActiveTexture) __glewActiveTexture = nullptr;
+	decltype(__glewAttachShader) __glewAttachShader = nullptr;
+	decltype(__glewBindBuffer) __glewBindBuffer = nullptr;
+	decltype(__glewBindBufferBase) __glewBindBufferBase = nullptr;
+	decltype(__glewBindBufferRange) __glewBindBufferRange = nullptr;
+	decltype(__glewBindVertexArray) __glewBindVertexArray = nullptr;
+	decltype(__glewBufferData) __glewBufferData = nullptr;
+	decltype(__glewBufferStorage) __glewBufferStorage = nullptr;
+	decltype(__glewBufferSubData) __glewBufferSubData = nullptr;
+	decltype(__glewClientWaitSync) __glewClientWaitSync = nullptr;
+	decltype(__glewCompileShader) __glewCompileShader = nullptr;
+	decltype(__glewCopyBufferSubData) __glewCopyBufferSubData = nullptr;
+	decltype(__glewCreateProgram) __glewCreateProgram = nullptr;
+	decltype(__glewCreateShader) __glewCreateShader = nullptr;
+	decltype(__glewDeleteBuffers) __glewDeleteBuffers = nullptr;
+	decltype(__glewDeleteProgram) __glewDeleteProgram = nullptr;
+	decltype(__glewDeleteShader) __glewDeleteShader = nullptr;
+	decltype(__glewDeleteSync) __glewDeleteSync = nullptr;
+	decltype(__glewDrawArraysInstanced) __glewDrawArraysInstanced = nullptr;
+	decltype(__glewDrawElementsBaseVertex) __glewDrawElementsBaseVertex = nullptr;
+	decltype(__glewDrawElementsInstancedBaseVertex) __glewDrawElementsInstancedBaseVertex = nullptr;
+	decltype(__glewEnableVertexAttribArray) __glewEnableVertexAttribArray = nullptr;
+	decltype(__glewFenceSync) __glewFenceSync = nullptr;
+	decltype(__glewGenBuffers) __glewGenBuffers = nullptr;
+	decltype(__glewGenVertexArrays) __glewGenVertexArrays = nullptr;
+	decltype(__glewGetActiveAttrib) __glewGetActiveAttrib = nullptr;
+	decltype(__glewGetActiveUniform) __glewGetActiveUniform = nullptr;
+	decltype(__glewGetActiveUniformBlockName) __glewGetActiveUniformBlockName = nullptr;
+	decltype(__glewGetActiveUniformBlockiv) __glewGetActiveUniformBlockiv = nullptr;
+	decltype(__glewGetActiveUniformsiv) __glewGetActiveUniformsiv = nullptr;
+	decltype(__glewGetAttribLocation) __glewGetAttribLocation = nullptr;
+	decltype(__glewGetProgramInfoLog) __glewGetProgramInfoLog = nullptr;
+	decltype(__glewGetProgramiv) __glewGetProgramiv = nullptr;
+	decltype(__glewGetShaderInfoLog) __glewGetShaderInfoLog = nullptr;
+	decltype(__glewGetShaderiv) __glewGetShaderiv = nullptr;
+	decltype(__glewGetUniformLocation) __glewGetUniformLocation = nullptr;
+	decltype(__glewLinkProgram) __glewLinkProgram = nullptr;
+	decltype(__glewMapBufferRange) __glewMapBufferRange = nullptr;
+	decltype(__glewMultiDrawElementsIndirect) __glewMultiDrawElementsIndirect = nullptr;
+	decltype(__glewShaderSource) __glewShaderSource = nullptr;
+	decltype(__glewUniform1f) __glewUniform1f = nullptr;
+	decltype(__glewUniform1i) __glewUniform1i = nullptr;
+	decltype(__glewUniform2f) __glewUniform2f = nullptr;
+	decltype(__glewUniform3f) __glewUniform3f = nullptr;
+	decltype(__glewUniform4f) __glewUniform4f = nullptr;
+	decltype(__glewUniformBlockBinding) __glewUniformBlockBinding = nullptr;
+	decltype(__glewUniformMatrix4fv) __glewUniformMatrix4fv = nullptr;
+	decltype(__glewUnmapBuffer) __glewUnmapBuffer = nullptr;
+	decltype(__glewUseProgram) __glewUseProgram = nullptr;
+	decltype(__glewVertexAttribDivisor) __glewVertexAttribDivisor = nullptr;
+	decltype(__glewVertexAttribPointer) __glewVertexAttribPointer = nullptr;
+}
+#endif
\ No newline at end of file
@@ -1,51 +1,286 @@
 #include "Core/graphics/ShaderProgram.hpp"
+#include "Core/graphics/GraphicsAPI.hpp"
+#include "Core/Engine.hpp"
+#include "Core/graphics/FrameUniforms.hpp"
+#include "Core/render/VertexLayout.hpp"
 #include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
 
 namespace LEN
 {
-	ShaderProgram::ShaderProgram(GLuint shaderProgramID) : m_shaderProgramID(shaderProgramID)
+	namespace
 	{
+		std::atomic<uint32_t> s_nextSortId{ 1 };
+	}
+
+	ShaderProgram::ShaderProgram(GLuint shaderProgramID, ShaderReflection reflection)
+		: m_reflection(std::move(reflection)), m_shaderProgramID(shaderProgramID), m_sortId(s_nextSortId.fetch_add(1, std::memory_order_relaxed))
+	{
+		m_uniformStates.resize(m_reflection.uniforms.size());
+		if (m_shaderProgramID != 0)
+		{
+			// Only at the standard location: the instance buffer layout is fixed
+			const auto* instanceModel = m_reflection.FindAttribute(StringId::Intern(InstanceModelAttribute));
+			m_instanced = instanceModel && instanceModel->location == static_cast<GLint>(InstanceModelLocation)
+				&& instanceModel->type == GL_FLOAT_MAT4;
 
+			// GLSL 330 cannot set the binding in the shader, it is assigned once here
+			if (const auto* block = m_reflection.FindBlock(StringId::Intern(FrameUniformsBlock)))
+			{
+				glUniformBlockBinding(m_shaderProgramID, block->index, FrameUniformsBinding);
+				m_usesFrameUniforms = true;
+			}
+			Validate();
+		}
+		m_materialLayout = MaterialLayout::Build(m_shaderProgramID, m_reflection);
 	}
 	ShaderProgram::~ShaderProgram()
 	{
-		glDeleteProgram(m_shaderProgramID);
+		if (m_shaderProgramID != 0)
+		{
+			// The render thread may still draw with it, the id is deleted after those frames
+			Engine::GetInstance().GetGraphicsAPI().ReleaseOnContext([id = m_shaderProgramID]() { glDeleteProgram(id); });
+		}
 	}
 
 	void ShaderProgram::Bind()
+	{
+		if (m_shaderProgramID != 0)
+		{
+			Engine::GetInstance().GetGraphicsAPI().UseProgram(m_shaderProgramID);
+		}
+	}
 
+	uint32_t ShaderProgram::GetSortId() const
 	{
-		glUseProgram(m_shaderProgramID);
+		return m_sortId;
 	}
 
-	GLint ShaderProgram::GetUniformLocation(const std::string& name)
+	bool ShaderProgram::IsInstanced() const
+	{
+		return m_instanced;
+	}
+
+	bool ShaderProgram::UsesFrameUniforms() const
 	{
-		auto it = m_uniformLocationCache.find(name);
-		if (it != m_uniformLocationCache.end())
+		return m_usesFrameUniforms;
+	}
+
+	const std::shared_ptr<const MaterialLayout>& ShaderProgram::GetMaterialLayout() const
+	{
+		return m_materialLayout;
+	}
+
+	const ShaderReflection& ShaderProgram::GetReflection() const
+	{
+		return m_reflection;
+	}
+
+	void ShaderProgram::Validate() const
+	{
+		const auto* instanceModel = m_reflection.FindAttribute(StringId::Intern(InstanceModelAttribute));
+		if (instanceModel && !m_instanced)
 		{
-			return it->second;
+			std::cerr << "Shader input " << InstanceModelAttribute << " must be a mat4 at location "
+				<< InstanceModelLocation << ", the program is drawn without instancing" << std::endl;
+		}
+
+		const auto* frameBlock = m_reflection.FindBlock(StringId::Intern(FrameUniformsBlock));
+		if (!frameBlock)
+		{
+			return;
+		}
+		// Whether the reported size includes the tail padding is up to the driver, so only the end of
+		// the last member is required; the members themselves must sit where FrameUniforms puts them
+		constexpr size_t usedSize = offsetof(FrameUniforms, deltaTime) + sizeof(float);
+		if (frameBlock->dataSize < static_cast<GLint>(usedSize))
+		{
+			std::cerr << "Uniform block " << FrameUniformsBlock << " is " << frameBlock->dataSize << " bytes, expected at least "
+				<< usedSize << "; declare it with " << FrameUniformsInclude << std::endl;
+		}
+		const std::pair<const char*, size_t> members[] = {
+			{ "uView", offsetof(FrameUniforms, view) },
+			{ "uProjection", offsetof(FrameUniforms, projection) },
+			{ "uViewProjection", offsetof(FrameUniforms, viewProjection) },
+			{ "uViewport", offsetof(FrameUniforms, viewport) },
+			{ "uTime", offsetof(FrameUniforms, time) },
+			{ "uDeltaTime", offsetof(FrameUniforms, deltaTime) },
+		};
+		for (const auto& [memberName, offset] : members)
+		{
+			const auto* member = m_reflection.FindUniform(StringId::Intern(memberName));
+			if (member && member->blockIndex == static_cast<GLint>(frameBlock->index) && member->offset != static_cast<GLint>(offset))
+			{
+				std::cerr << "Uniform block member " << FrameUniformsBlock << "." << memberName << " is at offset " << member->offset
+					<< ", expected " << offset << "; declare the block with " << FrameUniformsInclude << std::endl;
+			}
 		}
-		GLint location = glGetUniformLocation(m_shaderProgramID, name.c_str());
-		m_uniformLocationCache[name] = location;
-		return location;
+	}
+
+	UniformHandle ShaderProgram::FindUniform(StringId name) const
+	{
+		const auto* uniform = m_reflection.FindUniform(name);
+		if (!uniform || uniform->location < 0)
+		{
+			return UniformHandle{};
+		}
+		return UniformHandle{ static_cast<uint32_t>(uniform - m_reflection.uniforms.data()) };
+	}
+
+	UniformHandle ShaderProgram::ResolveName(StringId name)
+	{
+		const UniformHandle handle = FindUniform(name);
+		if (handle.IsValid() || m_shaderProgramID == 0)
+		{
+			return handle; // Headless programs have no uniforms to check against
+		}
+
+		if (std::find(m_reportedMissing.begin(), m_reportedMissing.end(), name) == m_reportedMissing.end())
+		{
+			m_reportedMissing.push_back(name);
+			const std::string_view text = name.GetString();
+			if (text.empty())
+			{
+				std::cerr << "Uniform id " << name.GetHash() << " was not interned and is not an active uniform" << std::endl;
+			}
+			else
+			{
+				std::cerr << "Uniform " << text << " is not an active uniform of program " << m_shaderProgramID
+					<< " (unused uniforms are removed at link)" << std::endl;
+			}
+		}
+		return handle;
+	}
+
+	bool ShaderProgram::PrepareUpload(UniformHandle handle, GLenum type, const void* value, uint32_t size)
+	{
+		if (!handle.IsValid())
+		{
+			return false;
+		}
+
+		const auto& uniform = m_reflection.uniforms[handle.index];
+		UniformState& state = m_uniformStates[handle.index];
+		if (uniform.type != type)
+		{
+			if (!state.reported)
+			{
+				state.reported = true;
+				std::cerr << "Uniform " << uniform.name.GetString() << " is a " << GetGLTypeName(uniform.type)
+					<< ", it cannot be set as a " << GetGLTypeName(type) << std::endl;
+			}
+			return false;
+		}
+
+		const bool same = state.size == size && std::memcmp(state.value.data(), value, size) == 0;
+		Engine::GetInstance().GetGraphicsAPI().CountUniformUpload(same);
+		if (same)
+		{
+			return false;
+		}
+		std::memcpy(state.value.data(), value, size);
+		state.size = size;
+		return true;
+	}
+
+	void ShaderProgram::SetUniform(UniformHandle handle, float value)
+	{
+		if (PrepareUpload(handle, GL_FLOAT, &value, sizeof(value)))
+		{
+			glUniform1f(m_reflection.uniforms[handle.index].location, value);
+		}
+	}
+
+	void ShaderProgram::SetUniform(UniformHandle handle, float v0, float v1)
+	{
+		const float value[2] = { v0, v1 };
+		if (PrepareUpload(handle, GL_FLOAT_VEC2, value, sizeof(value)))
+		{
+			glUniform2f(m_reflection.uniforms[handle.index].location, v0, v1);
+		}
+	}
+
+	void ShaderProgram::SetUniform(UniformHandle handle, const glm::vec3& value)
+	{
+		const float values[3] = { value.x, value.y, value.z };
+		if (PrepareUpload(handle, GL_FLOAT_VEC3, values, sizeof(values)))
+		{
+			glUniform3f(m_reflection.uniforms[handle.index].location, value.x, value.y, value.z);
+		}
+	}
+
+	void ShaderProgram::SetUniform(UniformHandle handle, const glm::vec4& value)
+	{
+		const float values[4] = { value.x, value.y, value.z, value.w };
+		if (PrepareUpload(handle, GL_FLOAT_VEC4, values, sizeof(values)))
+		{
+			glUniform4f(m_reflection.uniforms[handle.index].location, value.x, value.y, value.z, value.w);
+		}
+	}
+
+	void ShaderProgram::SetUniform(UniformHandle handle, int value)
+	{
+		// Samplers take their texture unit as an int
+		const GLenum type = handle.IsValid() && IsSamplerType(m_reflection.uniforms[handle.index].type)
+			? m_reflection.uniforms[handle.index].type : GL_INT;
+		if (PrepareUpload(handle, type, &value, sizeof(value)))
+		{
+			glUniform1i(m_reflection.uniforms[handle.index].location, value);
+		}
+	}
+
+	void ShaderProgram::SetUniform(UniformHandle handle, const glm::mat4& mat)
+	{
+		if (PrepareUpload(handle, GL_FLOAT_MAT4, glm::value_ptr(mat), sizeof(float) * 16))
+		{
+			glUniformMatrix4fv(m_reflection.uniforms[handle.index].location, 1, GL_FALSE, glm::value_ptr(mat));
+		}
+	}
+
+	GLint ShaderProgram::GetUniformLocation(const std::string& name)
+	{
+		return GetUniformLocation(StringId::Intern(name));
 	}
 
 	void ShaderProgram::SetUniform(const std::string& name, float value)
 	{
-		auto location = GetUniformLocation(name);
-		glUniform1f(location, value);
+		SetUniform(StringId::Intern(name), value);
 	}
 
 	void ShaderProgram::SetUniform(const std::string& name, float v0, float v1)
 	{
-		auto location = GetUniformLocation(name);
-		glUniform2f(location, v0, v1);
+		SetUniform(StringId::Intern(name), v0, v1);
 	}
 
 	void ShaderProgram::SetUniform(const std::string& name, const glm::mat4& mat)
 	{
-		auto location = GetUniformLocation(name);
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+		SetUniform(StringId::Intern(name), mat);
+	}
+
+	GLint ShaderProgram::GetUniformLocation(StringId name)
+	{
+		const UniformHandle handle = FindUniform(name);
+		return handle.IsValid() ? m_reflection.uniforms[handle.index].location : -1;
+	}
+
+	void ShaderProgram::SetUniform(StringId name, float value)
+	{
+		SetUniform(ResolveName(name), value);
+	}
+
+	void ShaderProgram::SetUniform(StringId name, float v0, float v1)
+	{
+		SetUniform(ResolveName(name), v0, v1);
+	}
+
+	void ShaderProgram::SetUniform(StringId name, const glm::mat4& mat)
+	{
+		SetUniform(ResolveName(name), mat);
 	}
 
 }
\ No newline at end of file
@@ -1,33 +1,100 @@
 #pragma once
 
 #include <GL/glew.h>
-#include <GLFW/glfw3.h>
+#include <array>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include "Core/strings/StringId.hpp"
+#include "Core/graphics/ShaderReflection.hpp"
+#include "Core/render/MaterialLayout.hpp"
+#include <memory>
 
 
 namespace LEN
 {
+    // Index of a uniform in one program's reflection table. Resolve it once with FindUniform and
+    // reuse it: setting through a handle is an array access, no hashing and no allocation. A handle
+    // is only meaningful for the program that returned it.
+    struct UniformHandle
+    {
+        static constexpr uint32_t Invalid = ~0u;
+        uint32_t index = Invalid;
+
+        bool IsValid() const { return index != Invalid; }
+    };
+
     class ShaderProgram
     {
     public:
         ShaderProgram() = delete;
         ShaderProgram(const ShaderProgram&) = delete;
         ShaderProgram& operator=(const ShaderProgram&) = delete;
-        explicit ShaderProgram(GLuint shaderProgramID);
+        // 0 for a headless program: every call is a no-op. On the context thread; reflection comes
+        // from GraphicsAPI::CreateShaderProgram
+        explicit ShaderProgram(GLuint shaderProgramID, ShaderReflection reflection = {});
         ~ShaderProgram();
 
         void Bind();
+        uint32_t GetSortId() const; // Small unique id for render sort keys, also for headless programs
+        // Declares the standard instance input (see InstanceModelLocation): RenderQueue draws its
+        // commands instanced, with the model matrix per instance instead of in uModel
+        bool IsInstanced() const;
+        // Declares the FrameUniforms block, which then reads the engine's per-frame buffer; camera
+        // matrices are not uploaded to it per program
+        bool UsesFrameUniforms() const;
+        // Reflected at creation, shared by the materials using this program
+        const std::shared_ptr<const MaterialLayout>& GetMaterialLayout() const;
+        const ShaderReflection& GetReflection() const;
+
+        // Invalid for names the program does not have or that live in a uniform block. Silent, so
+        // optional uniforms can be probed; the setters below report misuse.
+        UniformHandle FindUniform(StringId name) const;
+
+        // Uniform values are program state in GL: a value equal to the last one uploaded to this
+        // program is not uploaded again. The program must be bound (GraphicsAPI::UseProgram).
+        // A handle whose uniform has another type is reported once and ignored.
+        void SetUniform(UniformHandle handle, float value);
+        void SetUniform(UniformHandle handle, float v0, float v1);
+        void SetUniform(UniformHandle handle, const glm::vec3& value);
+        void SetUniform(UniformHandle handle, const glm::vec4& value);
+        void SetUniform(UniformHandle handle, int value);
+        void SetUniform(UniformHandle handle, const glm::mat4& mat);
+
+        // Name keyed versions resolve the handle on every call; names the program lacks are reported once
         GLint GetUniformLocation(const std::string& name);
         void SetUniform(const std::string& name, float value);
         void SetUniform(const std::string& name, float v0, float v1);
         void SetUniform(const std::string& name, const glm::mat4& mat);
+        GLint GetUniformLocation(StringId name);
+        void SetUniform(StringId name, float value);
+        void SetUniform(StringId name, float v0, float v1);
+        void SetUniform(StringId name, const glm::mat4& mat);
 
 
     private:
-        std::unordered_map<std::string, GLint> m_uniformLocationCache; // Cache for uniform locations
+        struct UniformState
+        {
+            uint32_t size = 0; // Bytes in value, 0 until the first upload
+            std::array<float, 16> value{};
+            bool reported = false; // A type mismatch was reported
+        };
+
+        // Checks the type and the cache; true when the GL call has to be made
+        bool PrepareUpload(UniformHandle handle, GLenum type, const void* value, uint32_t size);
+        UniformHandle ResolveName(StringId name); // FindUniform that reports missing names
+        void Validate() const; // Reports engine inputs declared with the wrong type or location
+
+        ShaderReflection m_reflection;
+        std::vector<UniformState> m_uniformStates; // Parallel to m_reflection.uniforms
+        std::vector<StringId> m_reportedMissing;
         GLuint m_shaderProgramID = 0; // Identifier for the shader program
+        uint32_t m_sortId = 0;
+        bool m_instanced = false;
+        bool m_usesFrameUniforms = false;
+        std::shared_ptr<const MaterialLayout> m_materialLayout;
     };
 
 }
\ No newline at end of file
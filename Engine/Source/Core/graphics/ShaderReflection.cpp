@@ -0,0 +1,172 @@
+#include "Core/graphics/ShaderReflection.hpp"
+#include <algorithm>
+#include <string>
+
+namespace LEN
+{
+	namespace
+	{
+		std::string BaseName(const char* name, GLsizei length)
+		{
+			std::string text(name, static_cast<size_t>(length));
+			if (text.size() > 3 && text.compare(text.size() - 3, 3, "[0]") == 0)
+			{
+				text.resize(text.size() - 3);
+			}
+			return text;
+		}
+
+		template<typename T>
+		void SortByName(std::vector<T>& entries)
+		{
+			std::sort(entries.begin(), entries.end(), [](const T& a, const T& b) { return a.name < b.name; });
+		}
+
+		template<typename T>
+		const T* FindByName(const std::vector<T>& entries, StringId name)
+		{
+			auto it = std::lower_bound(entries.begin(), entries.end(), name, [](const T& entry, StringId id) { return entry.name < id; });
+			return it != entries.end() && it->name == name ? &*it : nullptr;
+		}
+	}
+
+	ShaderReflection ShaderReflection::Reflect(GLuint programID)
+	{
+		ShaderReflection reflection;
+		if (programID == 0)
+		{
+			return reflection;
+		}
+
+		GLint maxLength = 0;
+		GLint length = 0;
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+		glGetProgramiv(programID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+		maxLength = std::max(maxLength, length);
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &length);
+		maxLength = std::max(maxLength, length);
+		std::vector<char> name(static_cast<size_t>(std::max(maxLength, 1)));
+
+		GLint count = 0;
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+		reflection.uniforms.reserve(static_cast<size_t>(count));
+		std::vector<GLuint> indices(static_cast<size_t>(count));
+		std::vector<GLint> blockIndices(indices.size());
+		std::vector<GLint> offsets(indices.size());
+		std::vector<GLint> matrixStrides(indices.size());
+		for (GLint i = 0; i < count; ++i)
+		{
+			indices[static_cast<size_t>(i)] = static_cast<GLuint>(i);
+		}
+		if (count > 0)
+		{
+			glGetActiveUniformsiv(programID, count, indices.data(), GL_UNIFORM_BLOCK_INDEX, blockIndices.data());
+			glGetActiveUniformsiv(programID, count, indices.data(), GL_UNIFORM_OFFSET, offsets.data());
+			glGetActiveUniformsiv(programID, count, indices.data(), GL_UNIFORM_MATRIX_STRIDE, matrixStrides.data());
+		}
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			GLsizei nameLength = 0;
+			Uniform uniform;
+			glGetActiveUniform(programID, indices[i], static_cast<GLsizei>(name.size()), &nameLength, &uniform.arraySize, &uniform.type, name.data());
+			uniform.blockIndex = blockIndices[i];
+			uniform.offset = offsets[i];
+			uniform.matrixStride = matrixStrides[i];
+
+			const std::string text = BaseName(name.data(), nameLength);
+			uniform.name = StringId::Intern(text);
+			if (uniform.blockIndex < 0)
+			{
+				uniform.location = glGetUniformLocation(programID, text.c_str());
+			}
+			reflection.uniforms.push_back(uniform);
+		}
+
+		glGetProgramiv(programID, GL_ACTIVE_ATTRIBUTES, &count);
+		reflection.attributes.reserve(static_cast<size_t>(count));
+		for (GLint i = 0; i < count; ++i)
+		{
+			GLsizei nameLength = 0;
+			Attribute attribute;
+			glGetActiveAttrib(programID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &nameLength, &attribute.arraySize, &attribute.type, name.data());
+			const std::string text = BaseName(name.data(), nameLength);
+			attribute.name = StringId::Intern(text);
+			attribute.location = glGetAttribLocation(programID, text.c_str()); // -1 for built-ins like gl_VertexID
+			reflection.attributes.push_back(attribute);
+		}
+
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+		reflection.blocks.reserve(static_cast<size_t>(count));
+		for (GLint i = 0; i < count; ++i)
+		{
+			GLsizei nameLength = 0;
+			Block block;
+			block.index = static_cast<GLuint>(i);
+			glGetActiveUniformBlockName(programID, block.index, static_cast<GLsizei>(name.size()), &nameLength, name.data());
+			glGetActiveUniformBlockiv(programID, block.index, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+			block.name = StringId::Intern(std::string(name.data(), static_cast<size_t>(nameLength)));
+			reflection.blocks.push_back(block);
+		}
+
+		SortByName(reflection.uniforms);
+		SortByName(reflection.attributes);
+		SortByName(reflection.blocks);
+		return reflection;
+	}
+
+	const ShaderReflection::Uniform* ShaderReflection::FindUniform(StringId name) const
+	{
+		return FindByName(uniforms, name);
+	}
+
+	const ShaderReflection::Attribute* ShaderReflection::FindAttribute(StringId name) const
+	{
+		return FindByName(attributes, name);
+	}
+
+	const ShaderReflection::Block* ShaderReflection::FindBlock(StringId name) const
+	{
+		return FindByName(blocks, name);
+	}
+
+	bool IsSamplerType(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_SAMPLER_2D:
+		case GL_SAMPLER_3D:
+		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_2D_SHADOW:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	const char* GetGLTypeName(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_FLOAT: return "float";
+		case GL_FLOAT_VEC2: return "vec2";
+		case GL_FLOAT_VEC3: return "vec3";
+		case GL_FLOAT_VEC4: return "vec4";
+		case GL_INT: return "int";
+		case GL_INT_VEC2: return "ivec2";
+		case GL_INT_VEC3: return "ivec3";
+		case GL_INT_VEC4: return "ivec4";
+		case GL_UNSIGNED_INT: return "uint";
+		case GL_BOOL: return "bool";
+		case GL_FLOAT_MAT2: return "mat2";
+		case GL_FLOAT_MAT3: return "mat3";
+		case GL_FLOAT_MAT4: return "mat4";
+		case GL_SAMPLER_2D: return "sampler2D";
+		case GL_SAMPLER_3D: return "sampler3D";
+		case GL_SAMPLER_CUBE: return "samplerCube";
+		case GL_SAMPLER_2D_ARRAY: return "sampler2DArray";
+		case GL_SAMPLER_2D_SHADOW: return "sampler2DShadow";
+		default: return "unknown";
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+#include "Core/strings/StringId.hpp"
+
+namespace LEN
+{
+	// Active uniforms, attributes and uniform blocks of a linked program, queried once after
+	// glLinkProgram. Each table is sorted by name hash; names are interned, so they can be printed.
+	// Arrays are listed once under their base name ("lights", not "lights[0]").
+	struct ShaderReflection
+	{
+		struct Uniform
+		{
+			StringId name;
+			GLint location = -1; // -1 for block members
+			GLenum type = 0; // GL_FLOAT, GL_FLOAT_VEC2, GL_FLOAT_MAT4, GL_SAMPLER_2D, ...
+			GLint arraySize = 1;
+			GLint blockIndex = -1; // Index into blocks' GL indices, -1 in the default block
+			GLint offset = -1; // Bytes into the block, -1 in the default block
+			GLint matrixStride = 0; // Bytes between the columns of a block member matrix
+		};
+
+		struct Attribute
+		{
+			StringId name;
+			GLint location = -1;
+			GLenum type = 0;
+			GLint arraySize = 1;
+		};
+
+		struct Block
+		{
+			StringId name;
+			GLuint index = GL_INVALID_INDEX;
+			GLint dataSize = 0; // Bytes
+		};
+
+		std::vector<Uniform> uniforms;
+		std::vector<Attribute> attributes;
+		std::vector<Block> blocks;
+
+		static ShaderReflection Reflect(GLuint programID); // On the context thread
+
+		// Binary searches; nullptr when the program has no active entry of that name
+		const Uniform* FindUniform(StringId name) const;
+		const Attribute* FindAttribute(StringId name) const;
+		const Block* FindBlock(StringId name) const;
+	};
+
+	const char* GetGLTypeName(GLenum type); // GLSL spelling, for validation messages
+	bool IsSamplerType(GLenum type);
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "Core/graphics/StreamBuffer.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace LEN
+{
+	namespace
+	{
+		constexpr GLuint64 FenceTimeout = 1000000000; // 1 s in nanoseconds, then warn and wait again
+
+		size_t AlignUp(size_t value, size_t alignment)
+		{
+			return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+		}
+	}
+
+	bool StreamBuffer::Create(size_t capacity)
+	{
+		Destroy();
+		if (capacity == 0)
+		{
+			return false;
+		}
+
+		glGenBuffers(1, &m_buffer);
+		// Target only used for the upload calls; the buffer serves any binding afterwards
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+		if (GLEW_ARB_buffer_storage)
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+			m_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(capacity), flags));
+			if (!m_mapped)
+			{
+				std::cerr << "StreamBuffer: persistent mapping failed, mapping per allocation" << std::endl;
+				glDeleteBuffers(1, &m_buffer);
+				glGenBuffers(1, &m_buffer);
+				glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+			}
+		}
+		if (!m_mapped)
+		{
+			glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		m_capacity = capacity;
+		return true;
+	}
+
+	void StreamBuffer::Destroy()
+	{
+		for (const Frame& frame : m_frames)
+		{
+			glDeleteSync(frame.fence);
+		}
+		m_frames.clear();
+		if (m_buffer != 0)
+		{
+			if (m_mapped)
+			{
+				glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+				glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+				glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			}
+			glDeleteBuffers(1, &m_buffer);
+		}
+		m_buffer = 0;
+		m_mapped = nullptr;
+		m_capacity = 0;
+		m_head = 0;
+		m_used = 0;
+		m_frameBytes = 0;
+	}
+
+	bool StreamBuffer::IsCreated() const
+	{
+		return m_buffer != 0;
+	}
+
+	bool StreamBuffer::IsPersistent() const
+	{
+		return m_mapped != nullptr;
+	}
+
+	size_t StreamBuffer::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	StreamBuffer::Allocation StreamBuffer::Allocate(size_t size, size_t alignment)
+	{
+		if (m_buffer == 0 || size == 0)
+		{
+			return {};
+		}
+
+		RetireFrames(false);
+		size_t offset = 0;
+		size_t consumed = 0;
+		for (;;)
+		{
+			// The free space runs from m_head around to the oldest frame in flight; an allocation
+			// that would cross the end of the buffer skips the tail and starts over at 0
+			offset = AlignUp(m_head, alignment);
+			if (offset + size > m_capacity)
+			{
+				offset = 0;
+				consumed = m_capacity - m_head + size;
+			}
+			else
+			{
+				consumed = offset + size - m_head;
+			}
+			if (consumed <= m_capacity - m_used)
+			{
+				break;
+			}
+			if (!RetireFrames(true))
+			{
+				std::cerr << "StreamBuffer: " << size << " bytes do not fit beside the frame's "
+					<< m_frameBytes << " of " << m_capacity << std::endl;
+				return {};
+			}
+			++m_waitCount;
+		}
+
+		m_head = offset + size;
+		m_used += consumed;
+		m_frameBytes += consumed;
+
+		Allocation allocation;
+		allocation.buffer = m_buffer;
+		allocation.offset = offset;
+		allocation.size = size;
+		if (m_mapped)
+		{
+			allocation.data = m_mapped + offset;
+		}
+		else
+		{
+			// The fences already keep the GPU off this range, so the driver need not synchronize
+			const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+			glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+			allocation.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), access);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+		return allocation;
+	}
+
+	void StreamBuffer::Commit(const Allocation& allocation)
+	{
+		// The persistent mapping is coherent, writes are visible to later commands
+		if (!allocation.IsValid() || m_mapped)
+		{
+			return;
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, allocation.buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	StreamBuffer::Allocation StreamBuffer::Write(const void* data, size_t size, size_t alignment)
+	{
+		Allocation allocation = Allocate(size, alignment);
+		if (allocation.IsValid())
+		{
+			std::memcpy(allocation.data, data, size);
+			Commit(allocation);
+		}
+		return allocation;
+	}
+
+	void StreamBuffer::EndFrame()
+	{
+		if (m_buffer == 0 || m_frameBytes == 0)
+		{
+			return;
+		}
+		Frame frame;
+		frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frame.bytes = m_frameBytes;
+		m_frames.push_back(frame);
+		m_frameBytes = 0;
+	}
+
+	uint32_t StreamBuffer::GetFramesInFlight() const
+	{
+		return static_cast<uint32_t>(m_frames.size());
+	}
+
+	uint32_t StreamBuffer::GetWaitCount() const
+	{
+		return m_waitCount;
+	}
+
+	bool StreamBuffer::RetireFrames(bool wait)
+	{
+		bool retired = false;
+		while (!m_frames.empty())
+		{
+			Frame& frame = m_frames.front();
+			GLenum status = glClientWaitSync(frame.fence, 0, 0);
+			if (status == GL_TIMEOUT_EXPIRED && wait && !retired)
+			{
+				// Flush so the fence is sure to be reached, then block
+				status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+				while (status == GL_TIMEOUT_EXPIRED)
+				{
+					std::cerr << "StreamBuffer: waiting on a frame the GPU has not finished" << std::endl;
+					status = glClientWaitSync(frame.fence, 0, FenceTimeout);
+				}
+			}
+			if (status == GL_TIMEOUT_EXPIRED)
+			{
+				break;
+			}
+			// Signaled, or the wait failed and nothing better can be done than to reuse the space
+			glDeleteSync(frame.fence);
+			m_used -= frame.bytes;
+			m_frames.pop_front();
+			retired = true;
+		}
+		return retired;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace LEN
+{
+	// Ring buffer for data written once per frame and read by that frame's draws: instance
+	// transforms, dynamic geometry, uniform blocks. Allocations are carved from one large buffer;
+	// EndFrame fences the frame, and space is reused only after the GPU has passed that fence.
+	// Persistently mapped where GL_ARB_buffer_storage exists, otherwise each allocation maps its
+	// range unsynchronized. Context thread only.
+	class StreamBuffer
+	{
+	public:
+		struct Allocation
+		{
+			void* data = nullptr; // Write-only, valid until Commit
+			GLuint buffer = 0;
+			size_t offset = 0; // Bytes into buffer, a multiple of the requested alignment
+			size_t size = 0;
+
+			bool IsValid() const { return data != nullptr; }
+		};
+
+		StreamBuffer() = default;
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+		bool Create(size_t capacity);
+		void Destroy();
+		bool IsCreated() const;
+		bool IsPersistent() const;
+		size_t GetCapacity() const;
+
+		// Invalid when size does not fit beside the current frame's allocations; blocks on the
+		// oldest fences while it does not fit beside frames still in flight
+		Allocation Allocate(size_t size, size_t alignment = 16);
+		void Commit(const Allocation& allocation); // Before the draws reading it are issued
+		Allocation Write(const void* data, size_t size, size_t alignment = 16); // Allocate, copy, Commit
+
+		void EndFrame(); // After the frame's draws are issued
+
+		uint32_t GetFramesInFlight() const;
+		uint32_t GetWaitCount() const; // Allocations that blocked on a fence, since Create
+
+	private:
+		struct Frame
+		{
+			GLsync fence = nullptr;
+			size_t bytes = 0; // Including alignment padding and the tail skipped on wrap
+		};
+
+		bool RetireFrames(bool wait); // Retires finished frames; with wait, at least the oldest
+
+		GLuint m_buffer = 0;
+		uint8_t* m_mapped = nullptr; // Persistent mapping
+		size_t m_capacity = 0;
+		size_t m_head = 0; // Next free byte
+		size_t m_used = 0; // Bytes from the oldest frame in flight up to m_head
+		size_t m_frameBytes = 0; // Of the frame being written
+		std::deque<Frame> m_frames; // In flight, oldest first
+		uint32_t m_waitCount = 0;
+	};
+}
\ No newline at end of file
@@ -20,5 +20,10 @@ namespace LEN
         }
 		return m_keys[key_index];
 	}
+
+	void InputManager::ReleaseAll()
+	{
+		m_keys.fill(false);
+	}
 }
 
@@ -1,6 +1,6 @@
 #pragma once
 #include <array>
-#include "Core/Input/InputKeys.hpp"
+#include "Core/input/InputKeys.hpp"
 
 namespace LEN
 {
@@ -17,6 +17,7 @@ namespace LEN
 
 		void SetKeyPressed(Key key, bool pressed);
 		bool IsKeyPressed(Key key) const;
+		void ReleaseAll();
 
 	private:
 		std::array<bool, static_cast<size_t>(Key::Count)> m_keys{};
@@ -0,0 +1,174 @@
+#include "Core/input/InputRecording.hpp"
+#include "Core/input/InputManager.hpp"
+#include <bit>
+#include <fstream>
+#include <iostream>
+
+namespace LEN
+{
+	namespace
+	{
+		static_assert(std::endian::native == std::endian::little, "Input recordings are stored little-endian");
+
+		constexpr uint32_t RecordingMagic = 0x494E454C; // "LENI"
+		constexpr uint32_t RecordingVersion = 1;
+
+		// Followed by float deltaTimes[frameCount], uint16_t changeCounts[frameCount] and
+		// uint16_t changes[changeCount]
+		struct RecordingHeader
+		{
+			uint32_t magic = RecordingMagic;
+			uint32_t version = RecordingVersion;
+			uint32_t keyCount = 0; // Key::Count when recorded, key values are not portable across changes
+			uint32_t frameCount = 0;
+			uint32_t changeCount = 0;
+			uint32_t reserved = 0;
+		};
+	}
+
+	void InputRecording::Clear()
+	{
+		m_deltaTimes.clear();
+		m_firstChange.clear();
+		m_changes.clear();
+		m_lastKeys.fill(false);
+	}
+
+	void InputRecording::RecordFrame(float deltaTime, const InputManager& input)
+	{
+		if (m_firstChange.empty())
+		{
+			m_firstChange.push_back(0);
+		}
+
+		for (size_t i = 1; i < KeyCount; ++i)
+		{
+			const bool pressed = input.IsKeyPressed(static_cast<Key>(i));
+			if (pressed != m_lastKeys[i])
+			{
+				m_changes.push_back(static_cast<uint16_t>(i | (pressed ? PressedBit : 0)));
+				m_lastKeys[i] = pressed;
+			}
+		}
+		m_deltaTimes.push_back(deltaTime);
+		m_firstChange.push_back(static_cast<uint32_t>(m_changes.size()));
+	}
+
+	void InputRecording::ApplyFrame(size_t frame, InputManager& input) const
+	{
+		for (uint32_t i = m_firstChange[frame]; i < m_firstChange[frame + 1]; ++i)
+		{
+			const uint16_t change = m_changes[i];
+			input.SetKeyPressed(static_cast<Key>(change & ~PressedBit), (change & PressedBit) != 0);
+		}
+	}
+
+	size_t InputRecording::GetFrameCount() const
+	{
+		return m_deltaTimes.size();
+	}
+
+	float InputRecording::GetDeltaTime(size_t frame) const
+	{
+		return m_deltaTimes[frame];
+	}
+
+	bool InputRecording::Save(const std::string& path) const
+	{
+		RecordingHeader header;
+		header.keyCount = static_cast<uint32_t>(KeyCount);
+		header.frameCount = static_cast<uint32_t>(m_deltaTimes.size());
+		header.changeCount = static_cast<uint32_t>(m_changes.size());
+
+		std::vector<uint16_t> changeCounts(m_deltaTimes.size());
+		for (size_t i = 0; i < changeCounts.size(); ++i)
+		{
+			changeCounts[i] = static_cast<uint16_t>(m_firstChange[i + 1] - m_firstChange[i]);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "InputRecording: cannot write " << path << std::endl;
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(m_deltaTimes.data()), static_cast<std::streamsize>(m_deltaTimes.size() * sizeof(float)));
+		file.write(reinterpret_cast<const char*>(changeCounts.data()), static_cast<std::streamsize>(changeCounts.size() * sizeof(uint16_t)));
+		file.write(reinterpret_cast<const char*>(m_changes.data()), static_cast<std::streamsize>(m_changes.size() * sizeof(uint16_t)));
+		if (!file)
+		{
+			std::cerr << "InputRecording: failed writing " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool InputRecording::Load(const std::string& path)
+	{
+		Clear();
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "InputRecording: cannot open " << path << std::endl;
+			return false;
+		}
+
+		RecordingHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || header.magic != RecordingMagic || header.version != RecordingVersion)
+		{
+			std::cerr << "InputRecording: " << path << " is not a version " << RecordingVersion << " recording" << std::endl;
+			return false;
+		}
+		if (header.keyCount != KeyCount)
+		{
+			std::cerr << "InputRecording: " << path << " was recorded with a different key set" << std::endl;
+			return false;
+		}
+
+		std::vector<uint16_t> changeCounts(header.frameCount);
+		m_deltaTimes.resize(header.frameCount);
+		m_changes.resize(header.changeCount);
+		file.read(reinterpret_cast<char*>(m_deltaTimes.data()), static_cast<std::streamsize>(m_deltaTimes.size() * sizeof(float)));
+		file.read(reinterpret_cast<char*>(changeCounts.data()), static_cast<std::streamsize>(changeCounts.size() * sizeof(uint16_t)));
+		file.read(reinterpret_cast<char*>(m_changes.data()), static_cast<std::streamsize>(m_changes.size() * sizeof(uint16_t)));
+		if (!file)
+		{
+			std::cerr << "InputRecording: " << path << " is truncated" << std::endl;
+			Clear();
+			return false;
+		}
+
+		// Validate before use: change counts must add up and every key must be known
+		m_firstChange.resize(header.frameCount + 1);
+		uint64_t total = 0;
+		for (size_t i = 0; i < changeCounts.size(); ++i)
+		{
+			m_firstChange[i] = static_cast<uint32_t>(total);
+			total += changeCounts[i];
+		}
+		m_firstChange[header.frameCount] = static_cast<uint32_t>(total);
+
+		bool valid = total == header.changeCount;
+		for (uint16_t change : m_changes)
+		{
+			const uint16_t key = change & ~PressedBit;
+			valid = valid && key != 0 && key < KeyCount;
+		}
+		if (!valid)
+		{
+			std::cerr << "InputRecording: " << path << " has corrupt key changes" << std::endl;
+			Clear();
+			return false;
+		}
+
+		// Continuing to record appends after the state the replay ends in
+		for (uint16_t change : m_changes)
+		{
+			m_lastKeys[change & ~PressedBit] = (change & PressedBit) != 0;
+		}
+		return true;
+	}
+}
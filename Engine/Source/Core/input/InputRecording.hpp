@@ -0,0 +1,41 @@
+#pragma once
+#include "Core/input/InputKeys.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LEN
+{
+	class InputManager;
+
+	// Per-frame input state and delta time of a session, replayed by Engine::ReplayInput to run
+	// exactly the same workload again. Only key transitions are stored, so an idle frame costs
+	// 6 bytes on disk.
+	class InputRecording
+	{
+	public:
+		void Clear();
+
+		// Appends a frame: deltaTime and the keys of input that changed since the previous frame
+		void RecordFrame(float deltaTime, const InputManager& input);
+		// Applies the key changes of frame to input. Frames must be applied in order, starting
+		// from released keys (InputManager::ReleaseAll).
+		void ApplyFrame(size_t frame, InputManager& input) const;
+
+		size_t GetFrameCount() const;
+		float GetDeltaTime(size_t frame) const;
+
+		bool Save(const std::string& path) const;
+		bool Load(const std::string& path); // Leaves the recording empty on failure
+
+	private:
+		static constexpr size_t KeyCount = static_cast<size_t>(Key::Count);
+		static constexpr uint16_t PressedBit = 0x8000; // Set in a change for a press, key in the low bits
+
+		std::vector<float> m_deltaTimes; // Per frame
+		std::vector<uint32_t> m_firstChange; // Per frame, index into m_changes, plus one end entry
+		std::vector<uint16_t> m_changes;
+		std::array<bool, KeyCount> m_lastKeys{}; // Key state of the last recorded frame
+	};
+}
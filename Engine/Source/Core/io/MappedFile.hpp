@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace LEN
+{
+	// Read-only memory mapping of a whole file. Pages are loaded by the OS on first touch,
+	// so opening is O(1) and reading a record costs no copy.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const;
+		const uint8_t* GetData() const; // Page aligned
+		size_t GetSize() const;
+
+	private:
+		void Swap(MappedFile& other) noexcept;
+
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr; // HANDLE
+		void* m_mapping = nullptr; // HANDLE
+#endif
+	};
+}
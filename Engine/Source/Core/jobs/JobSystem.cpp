@@ -0,0 +1,241 @@
+#include "Core/jobs/JobSystem.hpp"
+
+namespace LEN
+{
+	namespace
+	{
+		thread_local uint32_t t_threadIndex = 0;
+	}
+
+	bool JobCounter::IsDone() const
+	{
+		return m_pending.load(std::memory_order_acquire) == 0;
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	void JobSystem::Init(uint32_t threadCount)
+	{
+		if (m_running)
+		{
+			return;
+		}
+
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+		m_threadCount = threadCount;
+
+		m_queues.clear();
+		for (uint32_t i = 0; i < m_threadCount; ++i)
+		{
+			m_queues.push_back(std::make_unique<WorkerQueue>());
+		}
+
+		t_threadIndex = 0;
+		m_running = true;
+
+		for (uint32_t i = 1; i < m_threadCount; ++i)
+		{
+			m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+		}
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!m_running)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_running = false;
+		}
+		m_wakeCondition.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+		m_workers.clear();
+		m_queues.clear();
+		m_queuedJobs = 0;
+		m_threadCount = 1;
+	}
+
+	void JobSystem::Schedule(JobFunction function, JobCounter* counter)
+	{
+		if (counter)
+		{
+			counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+		Push(Job{ std::move(function), counter });
+	}
+
+	void JobSystem::Schedule(JobFunction function, JobCounter* counter, JobCounter& dependency)
+	{
+		if (counter)
+		{
+			counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Job job{ std::move(function), counter };
+		{
+			std::lock_guard<std::mutex> lock(dependency.m_mutex);
+			if (dependency.m_pending.load(std::memory_order_acquire) > 0)
+			{
+				dependency.m_continuations.push_back(std::move(job));
+				return;
+			}
+		}
+		Push(std::move(job));
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		const uint32_t threadIndex = GetCurrentThreadIndex();
+		while (!counter.IsDone())
+		{
+			if (!RunOne(threadIndex))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// The thread that finished the last job may still be releasing continuations
+		std::lock_guard<std::mutex> lock(counter.m_mutex);
+	}
+
+	uint32_t JobSystem::GetThreadCount() const
+	{
+		return m_threadCount;
+	}
+
+	uint32_t JobSystem::GetCurrentThreadIndex()
+	{
+		return t_threadIndex;
+	}
+
+	void JobSystem::Push(Job job)
+	{
+		if (m_queues.empty())
+		{
+			Execute(job); // Not initialized: behave like a single-threaded system
+			return;
+		}
+
+		// Threads the system does not know about share the main thread's queue
+		const uint32_t threadIndex = GetCurrentThreadIndex() < m_queues.size() ? GetCurrentThreadIndex() : 0;
+		{
+			std::lock_guard<std::mutex> lock(m_queues[threadIndex]->mutex);
+			m_queues[threadIndex]->jobs.push_back(std::move(job));
+		}
+		m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+		if (!m_workers.empty())
+		{
+			// Taking the lock orders this push against a worker that is about to sleep
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+			}
+			m_wakeCondition.notify_one();
+		}
+	}
+
+	bool JobSystem::TryPop(uint32_t threadIndex, Job& job)
+	{
+		auto& queue = *m_queues[threadIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+		{
+			return false;
+		}
+		job = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool JobSystem::TrySteal(uint32_t threadIndex, Job& job)
+	{
+		const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+		for (uint32_t offset = 1; offset < queueCount; ++offset)
+		{
+			auto& queue = *m_queues[(threadIndex + offset) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+				m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool JobSystem::RunOne(uint32_t threadIndex)
+	{
+		if (m_queues.empty())
+		{
+			return false;
+		}
+
+		threadIndex = threadIndex < m_queues.size() ? threadIndex : 0;
+		Job job;
+		if (TryPop(threadIndex, job) || TrySteal(threadIndex, job))
+		{
+			Execute(job);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		job.function();
+
+		JobCounter* counter = job.counter;
+		if (!counter)
+		{
+			return;
+		}
+
+		std::vector<Job> ready;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				ready.swap(counter->m_continuations);
+			}
+		}
+
+		for (auto& continuation : ready)
+		{
+			Push(std::move(continuation));
+		}
+	}
+
+	void JobSystem::WorkerMain(uint32_t threadIndex)
+	{
+		t_threadIndex = threadIndex;
+
+		while (m_running)
+		{
+			if (RunOne(threadIndex))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]() {
+				return m_queuedJobs.load(std::memory_order_acquire) > 0 || !m_running;
+			});
+		}
+	}
+}
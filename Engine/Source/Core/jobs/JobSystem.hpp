@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LEN
+{
+	class JobCounter;
+
+	using JobFunction = std::function<void()>;
+
+	struct Job
+	{
+		JobFunction function;
+		JobCounter* counter = nullptr; // Decremented once the job has run
+	};
+
+	// Tracks outstanding jobs. Jobs scheduled with a counter as dependency start once it drops to zero.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const;
+
+	private:
+		std::atomic<uint32_t> m_pending{ 0 };
+		std::mutex m_mutex; // Guards m_continuations and the transition to zero
+		std::vector<Job> m_continuations;
+
+		friend class JobSystem;
+	};
+
+	// Work-stealing job system. Every thread owns a deque: it pushes and pops at the back,
+	// idle threads steal from the front of the others. Thread 0 is the thread that called Init
+	// (the main thread); it only runs jobs while it is inside Wait or ParallelFor.
+	// With a thread count of 1 no workers are spawned and everything runs on the main thread in
+	// a fixed order, which keeps debugging deterministic.
+	class JobSystem
+	{
+	public:
+		JobSystem() = default;
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		~JobSystem();
+
+		void Init(uint32_t threadCount = 0); // 0 = one thread per hardware core, main thread included
+		void Shutdown();
+
+		void Schedule(JobFunction function, JobCounter* counter = nullptr);
+		void Schedule(JobFunction function, JobCounter* counter, JobCounter& dependency); // Runs after dependency reaches zero
+
+		// The calling thread executes queued jobs until the counter reaches zero
+		void Wait(JobCounter& counter);
+
+		// Calls body(chunkBegin, chunkEnd) over [begin, end) in chunks of grainSize and waits for all of them
+		template<typename Body>
+		void ParallelFor(size_t begin, size_t end, size_t grainSize, Body&& body)
+		{
+			if (begin >= end)
+			{
+				return;
+			}
+
+			grainSize = std::max<size_t>(grainSize, 1);
+			if (m_threadCount <= 1 || end - begin <= grainSize)
+			{
+				body(begin, end);
+				return;
+			}
+
+			JobCounter counter;
+			for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+			{
+				const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+				Schedule([&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); }, &counter);
+			}
+			Wait(counter);
+		}
+
+		uint32_t GetThreadCount() const;
+		static uint32_t GetCurrentThreadIndex(); // 0 for the main thread, 1..N-1 for workers
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		void Push(Job job);
+		bool TryPop(uint32_t threadIndex, Job& job);
+		bool TrySteal(uint32_t threadIndex, Job& job);
+		bool RunOne(uint32_t threadIndex);
+		void Execute(Job& job);
+		void WorkerMain(uint32_t threadIndex);
+
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+		std::atomic<uint32_t> m_queuedJobs{ 0 };
+		std::atomic<bool> m_running{ false };
+
+		uint32_t m_threadCount = 1;
+	};
+}
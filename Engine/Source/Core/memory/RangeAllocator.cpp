@@ -0,0 +1,134 @@
+#include "Core/memory/RangeAllocator.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace LEN
+{
+	RangeAllocator::RangeAllocator(uint32_t capacity)
+	{
+		Reset(capacity);
+	}
+
+	uint32_t RangeAllocator::Allocate(uint32_t size)
+	{
+		if (size == 0)
+		{
+			return InvalidOffset;
+		}
+
+		// Best fit keeps the large ranges for large requests
+		auto best = m_freeRanges.end();
+		for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it)
+		{
+			if (it->second >= size && (best == m_freeRanges.end() || it->second < best->second))
+			{
+				best = it;
+				if (it->second == size)
+				{
+					break;
+				}
+			}
+		}
+		if (best == m_freeRanges.end())
+		{
+			return InvalidOffset;
+		}
+
+		const uint32_t offset = best->first;
+		const uint32_t remaining = best->second - size;
+		m_freeRanges.erase(best);
+		if (remaining > 0)
+		{
+			m_freeRanges.emplace(offset + size, remaining);
+		}
+		m_used += size;
+		return offset;
+	}
+
+	void RangeAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		if (size == 0 || offset == InvalidOffset)
+		{
+			return;
+		}
+		assert(offset + size <= m_capacity && size <= m_used && "Freeing a range the allocator did not hand out");
+		m_used -= size;
+
+		auto next = m_freeRanges.lower_bound(offset);
+		if (next != m_freeRanges.end() && offset + size == next->first)
+		{
+			size += next->second;
+			next = m_freeRanges.erase(next);
+		}
+		if (next != m_freeRanges.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				previous->second += size;
+				return;
+			}
+		}
+		m_freeRanges.emplace_hint(next, offset, size);
+	}
+
+	void RangeAllocator::Grow(uint32_t capacity)
+	{
+		if (capacity <= m_capacity)
+		{
+			return;
+		}
+		const uint32_t offset = m_capacity;
+		const uint32_t size = capacity - m_capacity;
+		m_capacity = capacity;
+		m_used += size; // Free takes it back off
+		Free(offset, size);
+	}
+
+	void RangeAllocator::Reset(uint32_t capacity, uint32_t used)
+	{
+		m_freeRanges.clear();
+		m_capacity = capacity;
+		m_used = std::min(used, capacity);
+		if (m_used < capacity)
+		{
+			m_freeRanges.emplace(m_used, capacity - m_used);
+		}
+	}
+
+	uint32_t RangeAllocator::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	uint32_t RangeAllocator::GetUsed() const
+	{
+		return m_used;
+	}
+
+	uint32_t RangeAllocator::GetFree() const
+	{
+		return m_capacity - m_used;
+	}
+
+	uint32_t RangeAllocator::GetLargestFree() const
+	{
+		uint32_t largest = 0;
+		for (const auto& range : m_freeRanges)
+		{
+			largest = std::max(largest, range.second);
+		}
+		return largest;
+	}
+
+	uint32_t RangeAllocator::GetFreeRangeCount() const
+	{
+		return static_cast<uint32_t>(m_freeRanges.size());
+	}
+
+	float RangeAllocator::GetFragmentation() const
+	{
+		const uint32_t free = GetFree();
+		return free > 0 ? 1.0f - static_cast<float>(GetLargestFree()) / static_cast<float>(free) : 0.0f;
+	}
+}
\ No newline at end of file
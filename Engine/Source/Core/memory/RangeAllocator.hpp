@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <map>
+
+namespace LEN
+{
+	// Offset allocator over [0, capacity) in caller-defined units (bytes, vertices, indices). It
+	// only hands out offsets; the storage lives elsewhere, e.g. in a GPU buffer. Free ranges are
+	// kept by offset and merged with their neighbours on Free, allocation takes the best fit.
+	// Not thread-safe.
+	class RangeAllocator
+	{
+	public:
+		static constexpr uint32_t InvalidOffset = ~uint32_t(0);
+
+		explicit RangeAllocator(uint32_t capacity = 0);
+
+		uint32_t Allocate(uint32_t size); // InvalidOffset when no free range is large enough
+		void Free(uint32_t offset, uint32_t size);
+
+		void Grow(uint32_t capacity); // Appends the new space, merged with a free range at the end
+		void Reset(uint32_t capacity, uint32_t used = 0); // [0, used) taken, the rest one free range
+
+		uint32_t GetCapacity() const;
+		uint32_t GetUsed() const;
+		uint32_t GetFree() const;
+		uint32_t GetLargestFree() const;
+		uint32_t GetFreeRangeCount() const;
+		// 0 when all free space is one range, towards 1 the more it is split up
+		float GetFragmentation() const;
+
+	private:
+		std::map<uint32_t, uint32_t> m_freeRanges; // Offset to size, never adjacent
+		uint32_t m_capacity = 0;
+		uint32_t m_used = 0;
+	};
+}
\ No newline at end of file
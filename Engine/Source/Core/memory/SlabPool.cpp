@@ -0,0 +1,116 @@
+#include "Core/memory/SlabPool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace LEN
+{
+	SlabPool::SlabPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab)
+		: m_alignment(std::max(blockAlignment, alignof(FreeBlock))), m_blocksPerSlab(std::max<size_t>(blocksPerSlab, 1))
+	{
+		// Every block has to hold a free list link and keep the next block aligned
+		m_blockSize = std::max(blockSize, sizeof(FreeBlock));
+		m_blockSize = (m_blockSize + m_alignment - 1) / m_alignment * m_alignment;
+	}
+
+	SlabPool::~SlabPool()
+	{
+		Release();
+	}
+
+	void* SlabPool::Allocate()
+	{
+		if (!m_freeList)
+		{
+			AddSlab();
+		}
+
+		FreeBlock* block = m_freeList;
+		m_freeList = block->next;
+		++m_liveCount;
+		return block;
+	}
+
+	void SlabPool::Free(void* block)
+	{
+		assert(m_liveCount > 0 && "Freeing a block the pool did not hand out");
+		auto* freeBlock = static_cast<FreeBlock*>(block);
+		freeBlock->next = m_freeList;
+		m_freeList = freeBlock;
+		--m_liveCount;
+	}
+
+	void SlabPool::Release()
+	{
+		for (std::byte* slab : m_slabs)
+		{
+			::operator delete(slab, std::align_val_t(m_alignment));
+		}
+		m_slabs.clear();
+		m_freeList = nullptr;
+		m_liveCount = 0;
+	}
+
+	size_t SlabPool::GetBlockSize() const
+	{
+		return m_blockSize;
+	}
+
+	size_t SlabPool::GetLiveCount() const
+	{
+		return m_liveCount;
+	}
+
+	size_t SlabPool::GetSlabCount() const
+	{
+		return m_slabs.size();
+	}
+
+	void SlabPool::AddSlab()
+	{
+		auto* slab = static_cast<std::byte*>(::operator new(m_blockSize * m_blocksPerSlab, std::align_val_t(m_alignment)));
+		m_slabs.push_back(slab);
+
+		// Thread the blocks front to back so consecutive allocations are adjacent
+		for (size_t i = m_blocksPerSlab; i-- > 0;)
+		{
+			auto* block = reinterpret_cast<FreeBlock*>(slab + i * m_blockSize);
+			block->next = m_freeList;
+			m_freeList = block;
+		}
+	}
+
+	std::pmr::memory_resource* ObjectPools::GetResource()
+	{
+		return &m_arena;
+	}
+
+	void ObjectPools::Release()
+	{
+		for (auto& [type, pool] : m_pools)
+		{
+			pool->Release();
+		}
+		m_arena.release();
+	}
+
+	size_t ObjectPools::GetLiveCount() const
+	{
+		size_t count = 0;
+		for (const auto& [type, pool] : m_pools)
+		{
+			count += pool->GetLiveCount();
+		}
+		return count;
+	}
+
+	size_t ObjectPools::GetSlabCount() const
+	{
+		size_t count = 0;
+		for (const auto& [type, pool] : m_pools)
+		{
+			count += pool->GetSlabCount();
+		}
+		return count;
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace LEN
+{
+	// Fixed-size block allocator. Blocks are carved out of slabs of blocksPerSlab and recycled
+	// through an intrusive free list, so allocation and free are a couple of pointer writes and
+	// blocks of one type sit next to each other in memory. Not thread-safe.
+	class SlabPool
+	{
+	public:
+		SlabPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab = 256);
+		SlabPool(const SlabPool&) = delete;
+		SlabPool& operator=(const SlabPool&) = delete;
+		~SlabPool();
+
+		void* Allocate();
+		void Free(void* block);
+
+		// Returns every slab to the system in O(slabs). Blocks still in use must not be touched afterwards.
+		void Release();
+
+		size_t GetBlockSize() const;
+		size_t GetLiveCount() const; // Blocks handed out and not yet freed
+		size_t GetSlabCount() const;
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		void AddSlab();
+
+		size_t m_blockSize;
+		size_t m_alignment;
+		size_t m_blocksPerSlab;
+		std::vector<std::byte*> m_slabs;
+		FreeBlock* m_freeList = nullptr;
+		size_t m_liveCount = 0;
+	};
+
+	// unique_ptr deleter for objects placed in a SlabPool; without a pool it falls back to delete
+	template<typename T>
+	struct PoolDeleter
+	{
+		SlabPool* pool = nullptr;
+
+		void operator()(T* object) const
+		{
+			if (pool)
+			{
+				object->~T();
+				pool->Free(object);
+			}
+			else
+			{
+				delete object;
+			}
+		}
+	};
+
+	// One SlabPool per concrete type plus a pmr arena for variable sized data (names, small
+	// vectors). Owned by a Scene so everything it allocates can be dropped together.
+	class ObjectPools
+	{
+	public:
+		ObjectPools() = default;
+		ObjectPools(const ObjectPools&) = delete;
+		ObjectPools& operator=(const ObjectPools&) = delete;
+
+		template<typename T>
+		SlabPool& Get()
+		{
+			auto& pool = m_pools[std::type_index(typeid(T))];
+			if (!pool)
+			{
+				pool = std::make_unique<SlabPool>(sizeof(T), alignof(T));
+			}
+			return *pool;
+		}
+
+		// Shared by every thread that may rename objects during a parallel update, hence synchronized
+		std::pmr::memory_resource* GetResource();
+
+		void Release(); // Frees all slabs and the arena, O(slabs)
+
+		size_t GetLiveCount() const;
+		size_t GetSlabCount() const;
+
+	private:
+		std::pmr::synchronized_pool_resource m_arena;
+		std::unordered_map<std::type_index, std::unique_ptr<SlabPool>> m_pools;
+	};
+}
@@ -0,0 +1,90 @@
+#include "Core/profiling/FrameTimings.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace LEN
+{
+	void FrameTimings::SetEnabled(bool enabled)
+	{
+		m_enabled = enabled;
+	}
+
+	bool FrameTimings::IsEnabled() const
+	{
+		return m_enabled;
+	}
+
+	void FrameTimings::Add(float milliseconds)
+	{
+		if (m_enabled)
+		{
+			m_samples.push_back(milliseconds);
+		}
+	}
+
+	void FrameTimings::Clear()
+	{
+		m_samples.clear();
+	}
+
+	void FrameTimings::Reserve(size_t frameCount)
+	{
+		m_samples.reserve(frameCount);
+	}
+
+	const std::vector<float>& FrameTimings::GetSamples() const
+	{
+		return m_samples;
+	}
+
+	FrameTimings::Summary FrameTimings::Summarize() const
+	{
+		Summary summary;
+		if (m_samples.empty())
+		{
+			return summary;
+		}
+
+		std::vector<float> sorted(m_samples);
+		std::sort(sorted.begin(), sorted.end());
+
+		// Nearest-rank percentiles
+		auto percentile = [&](double p) {
+			const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+			return static_cast<double>(sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1]);
+		};
+
+		double total = 0.0;
+		for (float sample : sorted)
+		{
+			total += sample;
+		}
+
+		summary.count = sorted.size();
+		summary.mean = total / static_cast<double>(sorted.size());
+		summary.min = sorted.front();
+		summary.p50 = percentile(0.50);
+		summary.p90 = percentile(0.90);
+		summary.p99 = percentile(0.99);
+		summary.max = sorted.back();
+		return summary;
+	}
+
+	bool FrameTimings::WriteCsv(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "FrameTimings: cannot write " << path << std::endl;
+			return false;
+		}
+		file << "frame,ms\n";
+		for (size_t i = 0; i < m_samples.size(); ++i)
+		{
+			file << i << ',' << m_samples[i] << '\n';
+		}
+		return static_cast<bool>(file);
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace LEN
+{
+	// Per-frame CPU time samples, kept in full so runs can be compared by distribution (tail
+	// frames) and not only by average. Engine::Run adds one sample per frame while enabled.
+	class FrameTimings
+	{
+	public:
+		struct Summary
+		{
+			size_t count = 0;
+			double mean = 0.0; // Milliseconds
+			double min = 0.0;
+			double p50 = 0.0;
+			double p90 = 0.0;
+			double p99 = 0.0;
+			double max = 0.0;
+		};
+
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const;
+
+		void Add(float milliseconds); // Ignored while disabled
+		void Clear();
+		void Reserve(size_t frameCount);
+
+		const std::vector<float>& GetSamples() const; // In frame order
+		Summary Summarize() const;
+		bool WriteCsv(const std::string& path) const; // "frame,ms" per line
+
+	private:
+		std::vector<float> m_samples;
+		bool m_enabled = false;
+	};
+}
@@ -0,0 +1,215 @@
+#include "Core/render/FrustumCuller.hpp"
+#include "Core/render/RenderQueue.hpp"
+#include "Core/jobs/JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define LEN_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace LEN
+{
+	void FrustumCuller::SetJobSystem(JobSystem* jobSystem, size_t grainSize)
+	{
+		m_jobSystem = jobSystem;
+		m_grainSize = std::max<size_t>(grainSize, 4);
+	}
+
+	void FrustumCuller::SetEnabled(bool enabled)
+	{
+		m_enabled = enabled;
+	}
+
+	bool FrustumCuller::IsEnabled() const
+	{
+		return m_enabled;
+	}
+
+	void FrustumCuller::SetFrustum(const Frustum& frustum)
+	{
+		m_frustum = frustum;
+		m_visibleCount = 0;
+		m_culledCount = 0;
+	}
+
+	void FrustumCuller::Cull(const std::vector<RenderCommand>& commands, std::vector<RenderCommand>& visible)
+	{
+		Cull(commands.data(), commands.size(), visible);
+	}
+
+	void FrustumCuller::Cull(const RenderCommand* commands, size_t count, std::vector<RenderCommand>& visible)
+	{
+		Cull(std::vector<Span>{ Span{ commands, count } }, visible);
+	}
+
+	void FrustumCuller::Cull(const std::vector<Span>& spans, std::vector<RenderCommand>& visible)
+	{
+		size_t count = 0;
+		for (const Span& span : spans)
+		{
+			count += span.count;
+		}
+		if (!m_enabled)
+		{
+			for (const Span& span : spans)
+			{
+				visible.insert(visible.end(), span.commands, span.commands + span.count);
+			}
+			m_visibleCount += count;
+			return;
+		}
+
+		// Ranges start on a multiple of 4 within their span so every SIMD group belongs to exactly one job
+		const size_t grainSize = (m_grainSize + 3) & ~size_t(3);
+		m_spanBases.clear();
+		m_ranges.clear();
+		size_t padded = 0;
+		for (size_t s = 0; s < spans.size(); ++s)
+		{
+			const size_t spanPadded = (spans[s].count + 3) & ~size_t(3);
+			m_spanBases.push_back(padded);
+			for (size_t begin = 0; begin < spanPadded; begin += grainSize)
+			{
+				m_ranges.push_back(Range{ s, begin, std::min(spanPadded, begin + grainSize) });
+			}
+			padded += spanPadded;
+		}
+		for (auto* stream : { &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ })
+		{
+			stream->resize(padded);
+		}
+		m_visible.resize(padded);
+
+		auto testRanges = [this, &spans](size_t first, size_t last) {
+			for (size_t r = first; r < last; ++r)
+			{
+				const Range& range = m_ranges[r];
+				const Span& span = spans[range.span];
+				TestRange(span.commands, span.count, m_spanBases[range.span], range.begin, range.end);
+			}
+		};
+		if (m_jobSystem)
+		{
+			m_jobSystem->ParallelFor(0, m_ranges.size(), 1, testRanges);
+		}
+		else
+		{
+			testRanges(0, m_ranges.size());
+		}
+
+		const size_t firstVisible = visible.size();
+		for (size_t s = 0; s < spans.size(); ++s)
+		{
+			const uint8_t* spanVisible = m_visible.data() + m_spanBases[s];
+			for (size_t i = 0; i < spans[s].count; ++i)
+			{
+				if (spanVisible[i])
+				{
+					visible.push_back(spans[s].commands[i]);
+				}
+			}
+		}
+
+		const size_t visibleCount = visible.size() - firstVisible;
+		m_visibleCount += visibleCount;
+		m_culledCount += count - visibleCount;
+	}
+
+	size_t FrustumCuller::GetVisibleCount() const
+	{
+		return m_visibleCount;
+	}
+
+	size_t FrustumCuller::GetCulledCount() const
+	{
+		return m_culledCount;
+	}
+
+	void FrustumCuller::TestRange(const RenderCommand* commands, size_t count, size_t base, size_t begin, size_t end)
+	{
+		float* centerX = m_centerX.data() + base;
+		float* centerY = m_centerY.data() + base;
+		float* centerZ = m_centerZ.data() + base;
+		float* extentX = m_extentX.data() + base;
+		float* extentY = m_extentY.data() + base;
+		float* extentZ = m_extentZ.data() + base;
+		uint8_t* visible = m_visible.data() + base;
+
+		// Gather this range into SoA form while it is hot in cache; padding lanes get empty boxes
+		for (size_t i = begin; i < end; ++i)
+		{
+			glm::vec3 center(0.0f);
+			glm::vec3 extents(0.0f);
+			if (i < count)
+			{
+				center = commands[i].worldBounds.GetCenter();
+				extents = commands[i].worldBounds.GetExtents();
+			}
+			centerX[i] = center.x; centerY[i] = center.y; centerZ[i] = center.z;
+			extentX[i] = extents.x; extentY[i] = extents.y; extentZ[i] = extents.z;
+		}
+
+#ifdef LEN_CULL_SSE
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (size_t i = begin; i < end; i += 4)
+		{
+			const __m128 cx = _mm_loadu_ps(centerX + i);
+			const __m128 cy = _mm_loadu_ps(centerY + i);
+			const __m128 cz = _mm_loadu_ps(centerZ + i);
+			const __m128 ex = _mm_loadu_ps(extentX + i);
+			const __m128 ey = _mm_loadu_ps(extentY + i);
+			const __m128 ez = _mm_loadu_ps(extentZ + i);
+
+			__m128 outside = _mm_setzero_ps();
+			for (const auto& plane : m_frustum.planes)
+			{
+				const __m128 nx = _mm_set1_ps(plane.x);
+				const __m128 ny = _mm_set1_ps(plane.y);
+				const __m128 nz = _mm_set1_ps(plane.z);
+
+				// Signed distance of the center plus the box's projected radius on the normal
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+					_mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(plane.w)));
+				const __m128 radius = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+					_mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+					_mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+				distance = _mm_add_ps(distance, radius);
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+			}
+
+			const int outsideMask = _mm_movemask_ps(outside);
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				visible[i + lane] = (outsideMask & (1 << lane)) == 0;
+			}
+		}
+#else
+		for (size_t i = begin; i < end; ++i)
+		{
+			bool inside = true;
+			for (const auto& plane : m_frustum.planes)
+			{
+				const float distance = plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w;
+				const float radius = std::abs(plane.x) * extentX[i] + std::abs(plane.y) * extentY[i] + std::abs(plane.z) * extentZ[i];
+				if (distance + radius < 0.0f)
+				{
+					inside = false;
+					break;
+				}
+			}
+			visible[i] = inside;
+		}
+#endif
+
+		for (size_t i = begin; i < std::min(end, count); ++i)
+		{
+			if (!commands[i].hasBounds)
+			{
+				visible[i] = 1;
+			}
+		}
+	}
+}
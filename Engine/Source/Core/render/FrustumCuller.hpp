@@ -0,0 +1,68 @@
+#pragma once
+#include "Core/spatial/Frustum.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace LEN
+{
+	struct RenderCommand;
+	class JobSystem;
+
+	// Culling stage between RenderQueue::Submit and the draw loop. World bounds of the commands are
+	// copied into SoA arrays and tested four at a time against the frustum planes; ranges of
+	// grainSize commands are spread over the job system.
+	class FrustumCuller
+	{
+	public:
+		struct Span
+		{
+			const RenderCommand* commands = nullptr;
+			size_t count = 0;
+		};
+
+		void SetJobSystem(JobSystem* jobSystem, size_t grainSize = 1024); // nullptr culls on the calling thread
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const;
+
+		// Starts a new frame: resets the counts
+		void SetFrustum(const Frustum& frustum);
+
+		// Appends the visible commands to visible, keeping their order. Commands without bounds are always visible.
+		void Cull(const std::vector<RenderCommand>& commands, std::vector<RenderCommand>& visible);
+		void Cull(const RenderCommand* commands, size_t count, std::vector<RenderCommand>& visible);
+		// All spans in one dispatch, split into grainSize ranges across span boundaries; the visible
+		// commands are appended span after span
+		void Cull(const std::vector<Span>& spans, std::vector<RenderCommand>& visible);
+
+		size_t GetVisibleCount() const; // Since the last SetFrustum
+		size_t GetCulledCount() const;
+
+	private:
+		struct Range
+		{
+			size_t span;
+			size_t begin; // Within the span, a multiple of 4
+			size_t end;
+		};
+
+		// Indices are relative to the span, which starts at base in the SoA arrays
+		void TestRange(const RenderCommand* commands, size_t count, size_t base, size_t begin, size_t end);
+
+		Frustum m_frustum;
+		JobSystem* m_jobSystem = nullptr;
+		size_t m_grainSize = 1024;
+		bool m_enabled = true;
+
+		// Padded to a multiple of 4 so the SIMD loop never needs a tail
+		std::vector<float> m_centerX, m_centerY, m_centerZ;
+		std::vector<float> m_extentX, m_extentY, m_extentZ;
+		std::vector<uint8_t> m_visible;
+		std::vector<size_t> m_spanBases; // Each span padded to a multiple of 4 on its own
+		std::vector<Range> m_ranges;
+
+		size_t m_visibleCount = 0;
+		size_t m_culledCount = 0;
+	};
+}
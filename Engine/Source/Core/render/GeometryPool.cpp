@@ -0,0 +1,333 @@
+#include "Core/render/GeometryPool.hpp"
+#include "Core/graphics/GraphicsAPI.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace LEN
+{
+	namespace
+	{
+		// Doubles capacity until required fits; 0 when that would leave 32-bit offsets
+		uint32_t GrowCapacity(uint32_t capacity, uint64_t required)
+		{
+			uint64_t grown = std::max<uint64_t>(capacity, 1);
+			while (grown < required)
+			{
+				grown *= 2;
+			}
+			return grown <= std::numeric_limits<uint32_t>::max() ? static_cast<uint32_t>(grown) : 0;
+		}
+
+		const void* IndexOffset(uint32_t firstIndex)
+		{
+			return reinterpret_cast<const void*>(static_cast<uintptr_t>(firstIndex) * sizeof(uint32_t));
+		}
+	}
+
+	GeometryPool::GeometryPool(GraphicsAPI& graphicsAPI, const VertexLayout& layout)
+		: m_graphicsAPI(graphicsAPI), m_layout(layout)
+	{
+		Rebuild(InitialVertexCapacity, InitialIndexCapacity);
+	}
+
+	GeometryPool::Handle GeometryPool::Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		if (vertexCount == 0 || m_layout.stride == 0 || !Reserve(vertexCount, indexCount))
+		{
+			return InvalidHandle;
+		}
+
+		Range range;
+		range.vertexOffset = m_vertices.Allocate(vertexCount);
+		range.vertexCount = vertexCount;
+		if (indexCount > 0)
+		{
+			range.indexOffset = m_indices.Allocate(indexCount);
+			range.indexCount = indexCount;
+		}
+
+		// The copy targets leave the VAO's element buffer binding alone
+		const size_t stride = m_layout.stride;
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_VBO);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.vertexOffset * stride),
+			static_cast<GLsizeiptr>(vertexCount * stride), vertices);
+		if (indexCount > 0)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, m_EBO);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.indexOffset * sizeof(uint32_t)),
+				static_cast<GLsizeiptr>(indexCount * sizeof(uint32_t)), indices);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		Handle handle = InvalidHandle;
+		if (!m_freeHandles.empty())
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		else
+		{
+			handle = static_cast<Handle>(m_entries.size());
+			m_entries.emplace_back();
+		}
+		m_entries[handle].range = range;
+		m_entries[handle].live = true;
+		return handle;
+	}
+
+	void GeometryPool::Free(Handle handle)
+	{
+		if (handle >= m_entries.size() || !m_entries[handle].live)
+		{
+			return;
+		}
+		Entry& entry = m_entries[handle];
+		m_vertices.Free(entry.range.vertexOffset, entry.range.vertexCount);
+		m_indices.Free(entry.range.indexOffset, entry.range.indexCount);
+		entry = Entry();
+		m_freeHandles.push_back(handle);
+	}
+
+	GeometryPool::Range GeometryPool::GetRange(Handle handle) const
+	{
+		return handle < m_entries.size() ? m_entries[handle].range : Range();
+	}
+
+	void GeometryPool::Defragment()
+	{
+		if (m_vertices.GetFragmentation() > 0.0f || m_indices.GetFragmentation() > 0.0f)
+		{
+			Rebuild(m_vertices.GetCapacity(), m_indices.GetCapacity());
+		}
+	}
+
+	void GeometryPool::Bind()
+	{
+		m_graphicsAPI.BindVertexArray(m_VAO);
+	}
+
+	void GeometryPool::BindInstanceBuffer(GLuint buffer, size_t offset)
+	{
+		Bind(); // The attribute pointers are VAO state
+		if (buffer == m_instanceBuffer && offset == m_instanceOffset)
+		{
+			return;
+		}
+
+		m_graphicsAPI.BindBuffer(GL_ARRAY_BUFFER, buffer);
+		static const VertexLayout instanceLayout = VertexLayout::InstanceTransform();
+		for (auto& element : instanceLayout.elements)
+		{
+			glVertexAttribPointer(
+				element.index,
+				element.size,
+				element.type,
+				GL_FALSE,
+				static_cast<GLsizei>(instanceLayout.stride),
+				reinterpret_cast<void*>(static_cast<uintptr_t>(offset + element.offset))
+			);
+			if (m_instanceBuffer == 0)
+			{
+				glEnableVertexAttribArray(element.index);
+				glVertexAttribDivisor(element.index, element.divisor);
+			}
+		}
+		m_instanceBuffer = buffer;
+		m_instanceOffset = offset;
+	}
+
+	void GeometryPool::Draw(Handle handle)
+	{
+		const Range range = GetRange(handle);
+		if (range.vertexCount == 0)
+		{
+			return;
+		}
+		m_graphicsAPI.CountDrawCall();
+		if (range.indexCount > 0)
+		{
+			glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT,
+				const_cast<void*>(IndexOffset(range.indexOffset)), static_cast<GLint>(range.vertexOffset));
+		}
+		else
+		{
+			glDrawArrays(GL_TRIANGLES, static_cast<GLint>(range.vertexOffset), static_cast<GLsizei>(range.vertexCount));
+		}
+	}
+
+	void GeometryPool::DrawInstanced(Handle handle, uint32_t instanceCount)
+	{
+		const Range range = GetRange(handle);
+		if (range.vertexCount == 0 || instanceCount == 0)
+		{
+			return;
+		}
+		m_graphicsAPI.CountDrawCall(instanceCount);
+		if (range.indexCount > 0)
+		{
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT,
+				IndexOffset(range.indexOffset), static_cast<GLsizei>(instanceCount), static_cast<GLint>(range.vertexOffset));
+		}
+		else
+		{
+			glDrawArraysInstanced(GL_TRIANGLES, static_cast<GLint>(range.vertexOffset), static_cast<GLsizei>(range.vertexCount),
+				static_cast<GLsizei>(instanceCount));
+		}
+	}
+
+	void GeometryPool::MultiDrawIndirect(size_t offset, uint32_t drawCount)
+	{
+		if (drawCount == 0)
+		{
+			return;
+		}
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)),
+			static_cast<GLsizei>(drawCount), sizeof(DrawElementsIndirectCommand));
+	}
+
+	const VertexLayout& GeometryPool::GetLayout() const
+	{
+		return m_layout;
+	}
+
+	GeometryPool::Stats GeometryPool::GetStats() const
+	{
+		Stats stats;
+		stats.meshes = static_cast<uint32_t>(m_entries.size() - m_freeHandles.size());
+		stats.vertexCapacity = m_vertices.GetCapacity();
+		stats.vertexUsed = m_vertices.GetUsed();
+		stats.indexCapacity = m_indices.GetCapacity();
+		stats.indexUsed = m_indices.GetUsed();
+		stats.freeRanges = m_vertices.GetFreeRangeCount() + m_indices.GetFreeRangeCount();
+		stats.vertexFragmentation = m_vertices.GetFragmentation();
+		stats.indexFragmentation = m_indices.GetFragmentation();
+		stats.rebuilds = m_rebuilds;
+		return stats;
+	}
+
+	bool GeometryPool::Reserve(uint32_t vertexCount, uint32_t indexCount)
+	{
+		const bool verticesFit = m_vertices.GetLargestFree() >= vertexCount;
+		const bool indicesFit = indexCount == 0 || m_indices.GetLargestFree() >= indexCount;
+		if (verticesFit && indicesFit)
+		{
+			return true;
+		}
+
+		// Compacting joins the free space into one range at the end; grow only what is still short
+		const uint32_t vertexCapacity = GrowCapacity(m_vertices.GetCapacity(), uint64_t(m_vertices.GetUsed()) + vertexCount);
+		const uint32_t indexCapacity = GrowCapacity(m_indices.GetCapacity(), uint64_t(m_indices.GetUsed()) + indexCount);
+		if (vertexCapacity == 0 || indexCapacity == 0)
+		{
+			std::cerr << "GeometryPool: " << vertexCount << " vertices and " << indexCount
+				<< " indices do not fit in 32-bit offsets" << std::endl;
+			return false;
+		}
+		Rebuild(vertexCapacity, indexCapacity);
+		return true;
+	}
+
+	void GeometryPool::Rebuild(uint32_t vertexCapacity, uint32_t indexCapacity)
+	{
+		const size_t stride = m_layout.stride;
+		GLuint vertexBuffer = 0;
+		GLuint indexBuffer = 0;
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(vertexCapacity * stride), nullptr, GL_STATIC_DRAW);
+		glGenBuffers(1, &indexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(indexCapacity * sizeof(uint32_t)), nullptr, GL_STATIC_DRAW);
+
+		// Live ranges are packed in their current order, so neighbours stay neighbours
+		std::vector<Handle> live;
+		for (Handle handle = 0; handle < m_entries.size(); ++handle)
+		{
+			if (m_entries[handle].live)
+			{
+				live.push_back(handle);
+			}
+		}
+
+		std::sort(live.begin(), live.end(), [this](Handle a, Handle b) {
+			return m_entries[a].range.vertexOffset < m_entries[b].range.vertexOffset;
+		});
+		uint32_t vertexHead = 0;
+		glBindBuffer(GL_COPY_READ_BUFFER, m_VBO);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+		for (Handle handle : live)
+		{
+			Range& range = m_entries[handle].range;
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.vertexOffset * stride),
+				static_cast<GLintptr>(vertexHead * stride), static_cast<GLsizeiptr>(range.vertexCount * stride));
+			range.vertexOffset = vertexHead;
+			vertexHead += range.vertexCount;
+		}
+
+		std::sort(live.begin(), live.end(), [this](Handle a, Handle b) {
+			return m_entries[a].range.indexOffset < m_entries[b].range.indexOffset;
+		});
+		uint32_t indexHead = 0;
+		glBindBuffer(GL_COPY_READ_BUFFER, m_EBO);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+		for (Handle handle : live)
+		{
+			Range& range = m_entries[handle].range;
+			if (range.indexCount == 0)
+			{
+				continue;
+			}
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.indexOffset * sizeof(uint32_t)),
+				static_cast<GLintptr>(indexHead * sizeof(uint32_t)), static_cast<GLsizeiptr>(range.indexCount * sizeof(uint32_t)));
+			range.indexOffset = indexHead;
+			indexHead += range.indexCount;
+		}
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		// Deletion waits for draws still reading the old buffers
+		if (m_VBO != 0)
+		{
+			glDeleteBuffers(1, &m_VBO);
+			glDeleteBuffers(1, &m_EBO);
+			++m_rebuilds;
+		}
+		m_VBO = vertexBuffer;
+		m_EBO = indexBuffer;
+		m_vertices.Reset(vertexCapacity, vertexHead);
+		m_indices.Reset(indexCapacity, indexHead);
+		SetupVertexArray();
+	}
+
+	void GeometryPool::SetupVertexArray()
+	{
+		if (m_VAO == 0)
+		{
+			glGenVertexArrays(1, &m_VAO);
+		}
+		m_graphicsAPI.BindVertexArray(m_VAO);
+		m_graphicsAPI.BindBuffer(GL_ARRAY_BUFFER, m_VBO);
+
+		for (auto& element : m_layout.elements)
+		{
+			glVertexAttribPointer(
+				element.index,
+				element.size,
+				element.type,
+				element.normalized ? GL_TRUE : GL_FALSE,
+				static_cast<GLsizei>(m_layout.stride),
+				reinterpret_cast<void*>(static_cast<uintptr_t>(element.offset))
+			);
+			glEnableVertexAttribArray(element.index);
+			if (element.divisor != 0)
+			{
+				glVertexAttribDivisor(element.index, element.divisor);
+			}
+		}
+		m_graphicsAPI.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+
+		m_graphicsAPI.BindVertexArray(0);
+		m_graphicsAPI.BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/memory/RangeAllocator.hpp"
+#include "Core/render/VertexLayout.hpp"
+
+namespace LEN
+{
+	class GraphicsAPI;
+
+	// Layout of one command in a GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect
+	struct DrawElementsIndirectCommand
+	{
+		uint32_t count = 0;
+		uint32_t instanceCount = 0;
+		uint32_t firstIndex = 0;
+		int32_t baseVertex = 0;
+		uint32_t baseInstance = 0;
+	};
+
+	// Shared vertex and index buffers for every mesh of one VertexLayout, with one VAO over them.
+	// Meshes are handles to ranges of the two buffers; indices stay relative to their mesh and are
+	// drawn with a base vertex, so meshes of one pool are drawn without rebinding anything and a
+	// sorted run of them can go out as a single multi-draw. When a range does not fit, the pool
+	// compacts the live ranges into new buffers, growing them if compacting alone is not enough.
+	// GetGeometryPool on GraphicsAPI creates the pools; all calls on the context thread.
+	class GeometryPool
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle InvalidHandle = ~Handle(0);
+		static constexpr uint32_t InitialVertexCapacity = 64 * 1024;
+		static constexpr uint32_t InitialIndexCapacity = 192 * 1024;
+
+		struct Range
+		{
+			uint32_t vertexOffset = 0; // In vertices
+			uint32_t vertexCount = 0;
+			uint32_t indexOffset = 0; // In indices
+			uint32_t indexCount = 0; // 0 for meshes drawn without indices
+		};
+
+		struct Stats
+		{
+			uint32_t meshes = 0;
+			uint32_t vertexCapacity = 0;
+			uint32_t vertexUsed = 0;
+			uint32_t indexCapacity = 0;
+			uint32_t indexUsed = 0;
+			uint32_t freeRanges = 0; // Vertex and index free lists together
+			float vertexFragmentation = 0.0f; // See RangeAllocator::GetFragmentation
+			float indexFragmentation = 0.0f;
+			uint32_t rebuilds = 0; // Compactions, with or without growth
+		};
+
+		GeometryPool(GraphicsAPI& graphicsAPI, const VertexLayout& layout);
+		GeometryPool(const GeometryPool&) = delete;
+		GeometryPool& operator=(const GeometryPool&) = delete;
+
+		// vertices hold vertexCount vertices of the pool's stride
+		Handle Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+		void Free(Handle handle);
+		Range GetRange(Handle handle) const; // Moves when the pool compacts, so look it up per draw
+
+		void Defragment(); // Packs the live ranges to the front of the buffers
+
+		void Bind();
+		// Points the standard instance attributes (VertexLayout::InstanceTransform) at buffer + offset
+		// and binds the pool; skipped when they already point there
+		void BindInstanceBuffer(GLuint buffer, size_t offset);
+		void Draw(Handle handle); // After Bind
+		void DrawInstanced(Handle handle, uint32_t instanceCount); // After Bind and BindInstanceBuffer
+		// drawCount commands read from the bound GL_DRAW_INDIRECT_BUFFER at offset; their baseInstance
+		// counts from the offset given to BindInstanceBuffer
+		void MultiDrawIndirect(size_t offset, uint32_t drawCount);
+
+		const VertexLayout& GetLayout() const;
+		Stats GetStats() const;
+
+	private:
+		struct Entry
+		{
+			Range range;
+			bool live = false;
+		};
+
+		bool Reserve(uint32_t vertexCount, uint32_t indexCount); // Compacts and grows until both fit
+		void Rebuild(uint32_t vertexCapacity, uint32_t indexCapacity);
+		void SetupVertexArray();
+
+		GraphicsAPI& m_graphicsAPI;
+		VertexLayout m_layout;
+		GLuint m_VBO = 0;
+		GLuint m_EBO = 0;
+		GLuint m_VAO = 0;
+		GLuint m_instanceBuffer = 0; // Source of the instance attributes, 0 until the first instanced draw
+		size_t m_instanceOffset = 0;
+
+		RangeAllocator m_vertices;
+		RangeAllocator m_indices;
+		std::vector<Entry> m_entries; // Indexed by Handle
+		std::vector<Handle> m_freeHandles;
+		uint32_t m_rebuilds = 0;
+	};
+}
\ No newline at end of file
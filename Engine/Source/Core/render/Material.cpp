@@ -1,8 +1,49 @@
 #include "Core/render/Material.hpp"
 #include "Core/graphics/ShaderProgram.hpp"
+#include "Core/graphics/GraphicsAPI.hpp"
+#include "Core/Engine.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <atomic>
+#include <cstring>
+#include <iostream>
 
 namespace LEN
 {
+	namespace
+	{
+		std::atomic<uint32_t> s_nextSortId{ 1 };
+	}
+
+	Material::Material() : m_sortId(s_nextSortId.fetch_add(1, std::memory_order_relaxed))
+	{
+	}
+
+	Material::~Material()
+	{
+		if (m_uniformBuffer != 0)
+		{
+			// Frames in flight may still bind it
+			Engine::GetInstance().GetGraphicsAPI().ReleaseOnContext([buffer = m_uniformBuffer]() { glDeleteBuffers(1, &buffer); });
+		}
+	}
+
+	std::shared_ptr<Material> Material::CreateInstance(const std::shared_ptr<Material>& parent)
+	{
+		auto instance = std::make_shared<Material>();
+		if (!parent)
+		{
+			return instance;
+		}
+		parent->SyncWithParent();
+		instance->m_shaderProgram = parent->m_shaderProgram;
+		instance->m_layout = parent->m_layout;
+		instance->m_values = parent->m_values;
+		instance->m_textures = parent->m_textures;
+		instance->m_overridden.assign(parent->m_layout ? parent->m_layout->GetParams().size() : 0, false);
+		instance->m_parent = parent;
+		instance->m_parentVersion = parent->m_version;
+		return instance;
+	}
 
 	LEN::ShaderProgram* Material::GetShaderProgram()
 	{
@@ -12,19 +53,223 @@ namespace LEN
 	void Material::SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram)
 	{
 		m_shaderProgram = shaderProgram;
+		m_layout = shaderProgram ? shaderProgram->GetMaterialLayout() : nullptr;
+		m_parent.reset(); // Different parameters, nothing left to follow
+		m_values.assign(m_layout ? m_layout->GetBlockSize() : 0, std::byte{ 0 });
+		m_textures.assign(m_layout ? m_layout->GetSamplers().size() : 0, 0);
+		m_overridden.assign(m_layout ? m_layout->GetParams().size() : 0, false);
+		++m_version;
+	}
+
+	bool Material::SetParam(const std::string& name, float value)
+	{
+		return SetParam(StringId::Intern(name), value);
+	}
+
+	bool Material::SetParam(const std::string& name, float v0, float v1)
+	{
+		return SetParam(StringId::Intern(name), v0, v1);
+	}
+
+	bool Material::SetParam(StringId name, float value)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Float);
+		if (param)
+		{
+			WriteParam(*param, &value, 1, 1);
+		}
+		return param != nullptr;
 	}
 
-	void Material::SetParam(const std::string& name, float value)
+	bool Material::SetParam(StringId name, float v0, float v1)
 	{
-		m_floatParams[name] = value; // Store the float property
+		return SetParam(name, glm::vec2(v0, v1));
+	}
+
+	bool Material::SetParam(StringId name, const glm::vec2& value)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Vec2);
+		if (param)
+		{
+			const float values[2] = { value.x, value.y };
+			WriteParam(*param, values, 1, 2);
+		}
+		return param != nullptr;
+	}
+
+	bool Material::SetParam(StringId name, const glm::vec3& value)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Vec3);
+		if (param)
+		{
+			const float values[3] = { value.x, value.y, value.z };
+			WriteParam(*param, values, 1, 3);
+		}
+		return param != nullptr;
+	}
+
+	bool Material::SetParam(StringId name, const glm::vec4& value)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Vec4);
+		if (param)
+		{
+			const float values[4] = { value.x, value.y, value.z, value.w };
+			WriteParam(*param, values, 1, 4);
+		}
+		return param != nullptr;
+	}
+
+	bool Material::SetParam(StringId name, int value)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Int);
+		if (param)
+		{
+			std::memcpy(m_values.data() + param->offset, &value, sizeof(int));
+			MarkChanged(*param);
+		}
+		return param != nullptr;
+	}
+
+	bool Material::SetParam(StringId name, const glm::mat3& value)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Mat3);
+		if (param)
+		{
+			WriteParam(*param, glm::value_ptr(value), 3, 3);
+		}
+		return param != nullptr;
 	}
 
-	void Material::SetParam(const std::string& name, float v0, float v1)
+	bool Material::SetParam(StringId name, const glm::mat4& value)
 	{
-		m_flaot2Params[name] = { v0, v1 }; // Store the vec2 property
+		const auto* param = FindParam(name, MaterialParamType::Mat4);
+		if (param)
+		{
+			WriteParam(*param, glm::value_ptr(value), 4, 4);
+		}
+		return param != nullptr;
+	}
+
+	bool Material::SetTexture(StringId name, GLuint texture)
+	{
+		const auto* param = FindParam(name, MaterialParamType::Sampler);
+		if (param)
+		{
+			m_textures[param->offset] = texture;
+			MarkChanged(*param);
+		}
+		return param != nullptr;
+	}
+
+	const MaterialLayout::Param* Material::FindParam(StringId name, MaterialParamType type) const
+	{
+		const MaterialLayout::Param* param = m_layout ? m_layout->Find(name) : nullptr;
+		if (param && param->type == type)
+		{
+			return param;
+		}
+
+		// Headless programs reflect nothing, every parameter is missing there
+		if (!Engine::GetInstance().GetGraphicsAPI().IsHeadless())
+		{
+			if (param)
+			{
+				std::cerr << "Material parameter " << name.GetString() << " is a " << ToString(param->type)
+					<< ", not a " << ToString(type) << std::endl;
+			}
+			else
+			{
+				std::cerr << "Material parameter " << name.GetString() << " is not in the program's "
+					<< MaterialParamsBlock << " block" << std::endl;
+			}
+		}
+		return nullptr;
+	}
+
+	void Material::WriteParam(const MaterialLayout::Param& param, const float* values, uint32_t columns, uint32_t rows)
+	{
+		// std140 pads matrix columns to matrixStride; vectors are a single column
+		std::byte* target = m_values.data() + param.offset;
+		for (uint32_t column = 0; column < columns; ++column)
+		{
+			std::memcpy(target + column * param.matrixStride, values + column * rows, rows * sizeof(float));
+		}
+		MarkChanged(param);
+	}
+
+	void Material::MarkChanged(const MaterialLayout::Param& param)
+	{
+		if (m_parent)
+		{
+			m_overridden[&param - m_layout->GetParams().data()] = true;
+		}
+		++m_version;
+	}
+
+	void Material::SyncWithParent()
+	{
+		if (!m_parent)
+		{
+			return;
+		}
+		m_parent->SyncWithParent();
+		if (m_parentVersion == m_parent->m_version)
+		{
+			return;
+		}
+
+		const auto& params = m_layout->GetParams();
+		for (size_t i = 0; i < params.size(); ++i)
+		{
+			if (m_overridden[i])
+			{
+				continue;
+			}
+			if (params[i].type == MaterialParamType::Sampler)
+			{
+				m_textures[params[i].offset] = m_parent->m_textures[params[i].offset];
+			}
+			else
+			{
+				std::memcpy(m_values.data() + params[i].offset, m_parent->m_values.data() + params[i].offset, m_layout->GetParamSize(params[i]));
+			}
+		}
+		m_parentVersion = m_parent->m_version;
+		++m_version;
+	}
+
+	uint32_t Material::GetSortId() const
+	{
+		return m_sortId;
+	}
+
+	const MaterialLayout* Material::GetLayout() const
+	{
+		return m_layout.get();
+	}
+
+	const std::vector<std::byte>& Material::GetValues() const
+	{
+		return m_values;
+	}
+
+	MaterialSnapshot Material::Capture(std::vector<std::byte>& values, std::vector<GLuint>& textures)
+	{
+		SyncWithParent();
+
+		MaterialSnapshot snapshot;
+		snapshot.material = this;
+		snapshot.version = m_version;
+		snapshot.valueOffset = static_cast<uint32_t>(values.size());
+		snapshot.valueSize = static_cast<uint32_t>(m_values.size());
+		snapshot.textureOffset = static_cast<uint32_t>(textures.size());
+		snapshot.textureCount = static_cast<uint32_t>(m_textures.size());
+		values.insert(values.end(), m_values.begin(), m_values.end());
+		textures.insert(textures.end(), m_textures.begin(), m_textures.end());
+		return snapshot;
 	}
 
-	void Material::Bind()
+	void Material::Bind(const MaterialSnapshot& snapshot, const std::byte* values, const GLuint* textures)
 	{
 		if (!m_shaderProgram)
 		{
@@ -32,14 +277,22 @@ namespace LEN
 		}
 		m_shaderProgram->Bind();
 
-		for (const auto& praram : m_floatParams)
+		auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+		if (snapshot.valueSize > 0)
 		{
-			m_shaderProgram->SetUniform(praram.first, praram.second); // Set float uniform
+			// Versions only grow, so an older frame's values are never uploaded over newer ones
+			if (m_uploadedVersion != snapshot.version)
+			{
+				graphicsAPI.UploadUniformBuffer(m_uniformBuffer, m_uniformBufferSize, values + snapshot.valueOffset, snapshot.valueSize);
+				m_uploadedVersion = snapshot.version;
+			}
+			graphicsAPI.BindUniformBuffer(MaterialParamsBinding, m_uniformBuffer);
 		}
 
-		for (auto& param : m_flaot2Params)
+		const auto& samplers = m_layout->GetSamplers();
+		for (size_t i = 0; i < samplers.size() && i < snapshot.textureCount; ++i)
 		{
-			m_shaderProgram->SetUniform(param.first, param.second.first, param.second.second);
+			graphicsAPI.BindTexture(samplers[i].unit, samplers[i].target, textures[snapshot.textureOffset + i]);
 		}
 	}
 
@@ -1,28 +1,95 @@
 #pragma once
+#include "Core/strings/StringId.hpp"
+#include "Core/render/MaterialLayout.hpp"
+#include <GL/glew.h>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace LEN
 {
 	class ShaderProgram;
+	class Material;
 
+	// A material's parameters as of RenderQueue::Prepare. The render thread draws from this copy,
+	// never from the live values the main thread keeps setting for the next frame.
+	struct MaterialSnapshot
+	{
+		Material* material = nullptr;
+		uint64_t version = 0; // Of the values copied, decides whether the uniform buffer is stale
+		uint32_t valueOffset = 0; // Bytes into FramePacket::materialValues
+		uint32_t valueSize = 0;
+		uint32_t textureOffset = 0; // Into FramePacket::materialTextures
+		uint32_t textureCount = 0;
+	};
+
+	// Parameter values of a shader program's MaterialParams block (see MaterialLayout), kept as the
+	// block's bytes and uploaded as one uniform buffer range when they changed. Setters return false
+	// and report when the program has no parameter of that name and type.
 	class Material
 	{
 
 	public:
-		// Set the shader program used by this material
+		Material();
+		~Material();
+		Material(const Material&) = delete;
+		Material& operator=(const Material&) = delete;
+
+		// Shares parent's program and layout; values not set on the instance follow the parent
+		static std::shared_ptr<Material> CreateInstance(const std::shared_ptr<Material>& parent);
+
+		// Set the shader program used by this material; resets the values to zero
 		ShaderProgram* GetShaderProgram();
 		void SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram);
-		void SetParam(const std::string& name, float value);
-		void SetParam(const std::string& name, float v0, float v1);
-		void Bind();
+
+		bool SetParam(const std::string& name, float value); // Interns name
+		bool SetParam(const std::string& name, float v0, float v1);
+		bool SetParam(StringId name, float value); // name must be interned, see StringId::Intern
+		bool SetParam(StringId name, float v0, float v1);
+		bool SetParam(StringId name, const glm::vec2& value);
+		bool SetParam(StringId name, const glm::vec3& value);
+		bool SetParam(StringId name, const glm::vec4& value);
+		bool SetParam(StringId name, int value);
+		bool SetParam(StringId name, const glm::mat3& value);
+		bool SetParam(StringId name, const glm::mat4& value);
+		bool SetTexture(StringId name, GLuint texture); // For sampler uniforms
+
+		// Appends the current values and textures (parent's included) to values and textures; on
+		// the thread that sets the parameters
+		MaterialSnapshot Capture(std::vector<std::byte>& values, std::vector<GLuint>& textures);
+		// Binds program, parameter block and textures of a snapshot; on the context thread. values and
+		// textures are the arrays Capture appended to.
+		void Bind(const MaterialSnapshot& snapshot, const std::byte* values, const GLuint* textures);
+		uint32_t GetSortId() const; // Small unique id for render sort keys
+		const MaterialLayout* GetLayout() const;
+		const std::vector<std::byte>& GetValues() const; // Current values, not necessarily uploaded yet
 
 
 	private:
+		const MaterialLayout::Param* FindParam(StringId name, MaterialParamType type) const;
+		void WriteParam(const MaterialLayout::Param& param, const float* values, uint32_t columns, uint32_t rows);
+		void MarkChanged(const MaterialLayout::Param& param);
+		void SyncWithParent(); // Copies the parent's values not overridden here
+
 		std::shared_ptr<ShaderProgram> m_shaderProgram;
-		std::unordered_map<std::string, float> m_floatParams; // Example property: float values
-		std::unordered_map<std::string, std::pair<float, float>> m_flaot2Params; // Example property: vec2 values
+		std::shared_ptr<const MaterialLayout> m_layout;
+		std::shared_ptr<Material> m_parent;
+		std::vector<std::byte> m_values; // MaterialParams block, std140
+		std::vector<GLuint> m_textures; // Per MaterialLayout sampler
+		std::vector<bool> m_overridden; // Per layout parameter, instances only
+		uint64_t m_version = 1; // Bumped by every change, followed by instances
+		uint64_t m_parentVersion = 0;
+		uint64_t m_uploadedVersion = 0; // Context thread only, like m_uniformBuffer
+		GLuint m_uniformBuffer = 0;
+		size_t m_uniformBufferSize = 0; // Allocated size of m_uniformBuffer, context thread only
+		uint32_t m_sortId = 0;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "Core/render/MaterialLayout.hpp"
+#include "Core/graphics/GraphicsAPI.hpp"
+#include "Core/graphics/ShaderReflection.hpp"
+#include "Core/Engine.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace LEN
+{
+	namespace
+	{
+		bool ToParamType(GLenum glType, MaterialParamType& type)
+		{
+			switch (glType)
+			{
+			case GL_FLOAT: type = MaterialParamType::Float; return true;
+			case GL_FLOAT_VEC2: type = MaterialParamType::Vec2; return true;
+			case GL_FLOAT_VEC3: type = MaterialParamType::Vec3; return true;
+			case GL_FLOAT_VEC4: type = MaterialParamType::Vec4; return true;
+			case GL_INT: type = MaterialParamType::Int; return true;
+			case GL_FLOAT_MAT3: type = MaterialParamType::Mat3; return true;
+			case GL_FLOAT_MAT4: type = MaterialParamType::Mat4; return true;
+			default: return false;
+			}
+		}
+
+		bool ToSamplerTarget(GLenum glType, GLenum& target)
+		{
+			switch (glType)
+			{
+			case GL_SAMPLER_2D: target = GL_TEXTURE_2D; return true;
+			case GL_SAMPLER_3D: target = GL_TEXTURE_3D; return true;
+			case GL_SAMPLER_CUBE: target = GL_TEXTURE_CUBE_MAP; return true;
+			case GL_SAMPLER_2D_ARRAY: target = GL_TEXTURE_2D_ARRAY; return true;
+			case GL_SAMPLER_2D_SHADOW: target = GL_TEXTURE_2D; return true;
+			default: return false;
+			}
+		}
+	}
+
+	std::shared_ptr<const MaterialLayout> MaterialLayout::Build(GLuint programID, const ShaderReflection& reflection)
+	{
+		auto layout = std::make_shared<MaterialLayout>();
+		if (programID == 0)
+		{
+			return layout;
+		}
+
+		const auto* block = reflection.FindBlock(StringId::Intern(MaterialParamsBlock));
+		if (block)
+		{
+			glUniformBlockBinding(programID, block->index, MaterialParamsBinding);
+			layout->m_blockSize = static_cast<uint32_t>(block->dataSize);
+		}
+
+		for (const auto& uniform : reflection.uniforms)
+		{
+			Param param;
+			param.name = uniform.name;
+			if (block && uniform.blockIndex == static_cast<GLint>(block->index))
+			{
+				if (!ToParamType(uniform.type, param.type))
+				{
+					std::cerr << "Material parameter " << uniform.name.GetString() << " has an unsupported type, it is ignored" << std::endl;
+					continue;
+				}
+				param.offset = static_cast<uint32_t>(uniform.offset);
+				param.matrixStride = static_cast<uint32_t>(uniform.matrixStride);
+				layout->m_params.push_back(param);
+				continue;
+			}
+
+			// Samplers are default block uniforms; each gets the next unit, fixed for the program's lifetime
+			Sampler sampler;
+			if (uniform.blockIndex >= 0 || !ToSamplerTarget(uniform.type, sampler.target))
+			{
+				continue;
+			}
+			sampler.location = uniform.location;
+			sampler.unit = static_cast<GLuint>(layout->m_samplers.size());
+			param.type = MaterialParamType::Sampler;
+			param.offset = static_cast<uint32_t>(layout->m_samplers.size());
+			layout->m_params.push_back(param);
+			layout->m_samplers.push_back(sampler);
+		}
+
+		if (!layout->m_samplers.empty())
+		{
+			// Sampler units are program state, set once; GL 3.3 can only set uniforms of the bound program
+			auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+			graphicsAPI.UseProgram(programID);
+			for (auto& sampler : layout->m_samplers)
+			{
+				glUniform1i(sampler.location, static_cast<GLint>(sampler.unit));
+			}
+		}
+
+		return layout; // In the reflection's order, which is sorted by name
+	}
+
+	const MaterialLayout::Param* MaterialLayout::Find(StringId name) const
+	{
+		auto it = std::lower_bound(m_params.begin(), m_params.end(), name, [](const Param& param, StringId id) { return param.name < id; });
+		return it != m_params.end() && it->name == name ? &*it : nullptr;
+	}
+
+	const std::vector<MaterialLayout::Param>& MaterialLayout::GetParams() const
+	{
+		return m_params;
+	}
+
+	const std::vector<MaterialLayout::Sampler>& MaterialLayout::GetSamplers() const
+	{
+		return m_samplers;
+	}
+
+	uint32_t MaterialLayout::GetBlockSize() const
+	{
+		return m_blockSize;
+	}
+
+	uint32_t MaterialLayout::GetParamSize(const Param& param) const
+	{
+		switch (param.type)
+		{
+		case MaterialParamType::Float: return 4;
+		case MaterialParamType::Vec2: return 8;
+		case MaterialParamType::Vec3: return 12;
+		case MaterialParamType::Vec4: return 16;
+		case MaterialParamType::Int: return 4;
+		case MaterialParamType::Mat3: return 2 * param.matrixStride + 12; // Last column without its padding
+		case MaterialParamType::Mat4: return 3 * param.matrixStride + 16;
+		case MaterialParamType::Sampler: return 0;
+		}
+		return 0;
+	}
+
+	const char* ToString(MaterialParamType type)
+	{
+		switch (type)
+		{
+		case MaterialParamType::Float: return "float";
+		case MaterialParamType::Vec2: return "vec2";
+		case MaterialParamType::Vec3: return "vec3";
+		case MaterialParamType::Vec4: return "vec4";
+		case MaterialParamType::Int: return "int";
+		case MaterialParamType::Mat3: return "mat3";
+		case MaterialParamType::Mat4: return "mat4";
+		case MaterialParamType::Sampler: return "sampler";
+		}
+		return "unknown";
+	}
+}
\ No newline at end of file
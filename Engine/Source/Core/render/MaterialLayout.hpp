@@ -0,0 +1,69 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Core/strings/StringId.hpp"
+
+namespace LEN
+{
+	struct ShaderReflection;
+
+	// Material parameters live in a std140 uniform block of the program, declared for example as
+	//     layout (std140) uniform MaterialParams { vec4 uColor; float uRoughness; };
+	// and bound at MaterialParamsBinding. Samplers cannot be block members, they are plain uniforms
+	// and get a texture unit each.
+	constexpr GLuint MaterialParamsBinding = 1; // FrameUniformsBinding is 0
+	constexpr const char* MaterialParamsBlock = "MaterialParams";
+
+	enum class MaterialParamType : uint8_t
+	{
+		Float,
+		Vec2,
+		Vec3,
+		Vec4,
+		Int,
+		Mat3,
+		Mat4,
+		Sampler, // Any sampler type; the value is a GL texture name
+	};
+
+	// Typed offsets of a program's material parameters, built once from the program's reflection
+	// when it is created and shared by every material using it. Lookups are by interned name, done when a
+	// parameter is set; binding a material does no name work.
+	class MaterialLayout
+	{
+	public:
+		struct Param
+		{
+			StringId name;
+			MaterialParamType type = MaterialParamType::Float;
+			uint32_t offset = 0; // Bytes into the block; for samplers the index into the texture list
+			uint32_t matrixStride = 0; // Bytes between matrix columns
+		};
+
+		struct Sampler
+		{
+			GLint location = -1;
+			GLuint unit = 0;
+			GLenum target = GL_TEXTURE_2D;
+		};
+
+		// On the context thread; also assigns the block binding and the sampler units. Program 0
+		// gives an empty layout.
+		static std::shared_ptr<const MaterialLayout> Build(GLuint programID, const ShaderReflection& reflection);
+
+		const Param* Find(StringId name) const; // nullptr when the program has no such parameter
+		const std::vector<Param>& GetParams() const; // Sorted by name hash
+		const std::vector<Sampler>& GetSamplers() const;
+		uint32_t GetBlockSize() const; // 0 without a MaterialParams block
+		uint32_t GetParamSize(const Param& param) const; // Bytes the parameter takes in the block
+
+	private:
+		std::vector<Param> m_params;
+		std::vector<Sampler> m_samplers;
+		uint32_t m_blockSize = 0;
+	};
+
+	const char* ToString(MaterialParamType type);
+}
\ No newline at end of file
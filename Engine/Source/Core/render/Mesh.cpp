@@ -1,105 +1,190 @@
 #include "Core/render/Mesh.hpp"
+#include "Core/render/VertexCompression.hpp"
 #include "Core/graphics/GraphicsAPI.hpp"
 #include "Core/Engine.hpp"
 #include <GL/glew.h>
 #include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
 
 
 namespace LEN
 {
+	namespace
+	{
+		std::atomic<uint32_t> s_nextSortId{ 1 };
+	}
+
 	Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices, const std::vector<uint32_t>& indices)
+		: Mesh(layout, vertices.data(), vertices.size() * sizeof(float), indices)
 	{
-		m_vertexLayout = layout;
+	}
 
-		auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI(); // Get GraphicsAPI instance
+	Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices)
+		: Mesh(layout, vertices, {})
+	{
+	}
 
-		// Create and upload vertex/index buffers using GraphicsAPI
-		m_VBO = graphicsAPI.CreateVertexBuffer(vertices);
-		m_EBO = graphicsAPI.CreateIndexBuffer(indices);
+	Mesh::Mesh(const VertexLayout& layout, const std::vector<uint8_t>& vertexData, const std::vector<uint32_t>& indices)
+		: Mesh(layout, vertexData.data(), vertexData.size(), indices)
+	{
+	}
+
+	Mesh::Mesh(const VertexLayout& layout, const void* vertexData, size_t vertexBytes, const std::vector<uint32_t>& indices)
+	{
+		m_vertexLayout = layout;
+		m_sortId = s_nextSortId.fetch_add(1, std::memory_order_relaxed);
 
-		glGenVertexArrays(1, &m_VAO); // Generate VAO
-		glBindVertexArray(m_VAO); // Bind VAO
+		// m_vertexLayout.stride is in bytes
+		m_vertexCount = m_vertexLayout.stride > 0 ? vertexBytes / static_cast<size_t>(m_vertexLayout.stride) : 0;
+		m_indexCount = indices.size();
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO); // Bind VBO
+		Upload(vertexData, indices);
+		ComputeBounds(static_cast<const uint8_t*>(vertexData));
+	}
 
-		for (auto& element : m_vertexLayout.elements)
+	Mesh::~Mesh()
+	{
+		if (!m_pool)
 		{
-			glVertexAttribPointer(
-				element.index,
-				element.size,
-				element.type,
-				GL_FALSE,
-				static_cast<GLsizei>(m_vertexLayout.stride),
-				reinterpret_cast<void*>(static_cast<uintptr_t>(element.offset))
-			);
-			glEnableVertexAttribArray(element.index);
+			return;
 		}
+		// After the frames already submitted, which may still draw this mesh
+		GeometryPool* pool = m_pool;
+		const GeometryPool::Handle geometry = m_geometry;
+		Engine::GetInstance().GetGraphicsAPI().ReleaseOnContext([pool, geometry]() { pool->Free(geometry); });
+	}
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+	void Mesh::Upload(const void* vertexData, const std::vector<uint32_t>& indices)
+	{
+		auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+		if (graphicsAPI.IsHeadless() || m_vertexCount == 0)
+		{
+			return; // No context: the mesh keeps its counts and bounds only
+		}
 
-		// Set 0 for Buffer's
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		graphicsAPI.RunOnContext([&]() {
+			GeometryPool* pool = graphicsAPI.GetGeometryPool(m_vertexLayout);
+			const GeometryPool::Handle geometry = pool->Allocate(vertexData, static_cast<uint32_t>(m_vertexCount),
+				indices.empty() ? nullptr : indices.data(), static_cast<uint32_t>(m_indexCount));
+			if (geometry != GeometryPool::InvalidHandle)
+			{
+				m_pool = pool;
+				m_geometry = geometry;
+			}
+		});
+	}
 
-		// vertices.size() returns number of floats; m_vertexLayout.stride is in bytes.
-		// Convert float count to bytes before dividing by stride to get vertex count.
-		m_vertexCount = (vertices.size() * sizeof(float)) / static_cast<size_t>(m_vertexLayout.stride);
-		m_indexCount = indices.size();
+	void Mesh::Bind()
+	{
+		if (!m_pool)
+		{
+			return;
+		}
+		m_pool->Bind();
 	}
 
-	Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices)
+	void Mesh::Draw()
 	{
-		m_vertexLayout = layout;
+		if (!m_pool)
+		{
+			return;
+		}
+		m_pool->Draw(m_geometry);
+	}
 
-		auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI(); // Get GraphicsAPI instance
+	void Mesh::BindInstanceBuffer(GLuint buffer, size_t offset)
+	{
+		if (!m_pool)
+		{
+			return;
+		}
+		m_pool->BindInstanceBuffer(buffer, offset);
+	}
 
-		// Create and upload vertex/index buffers using GraphicsAPI
-		m_VBO = graphicsAPI.CreateVertexBuffer(vertices);
+	void Mesh::DrawInstanced(uint32_t instanceCount)
+	{
+		if (!m_pool)
+		{
+			return;
+		}
+		m_pool->DrawInstanced(m_geometry, instanceCount);
+	}
 
-		glGenVertexArrays(1, &m_VAO); // Generate VAO
-		glBindVertexArray(m_VAO); // Bind VAO
+	GeometryPool* Mesh::GetGeometryPool() const
+	{
+		return m_pool;
+	}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO); // Bind VBO
+	GeometryPool::Handle Mesh::GetGeometryHandle() const
+	{
+		return m_geometry;
+	}
 
-		for (auto& element : m_vertexLayout.elements)
-		{
-			glVertexAttribPointer(
-				element.index,
-				element.size,
-				element.type,
-				GL_FALSE,
-				static_cast<GLsizei>(m_vertexLayout.stride),
-				reinterpret_cast<void*>(static_cast<uintptr_t>(element.offset))
-			);
-			glEnableVertexAttribArray(element.index);
-		}
-		// Set 0 for Buffer's
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	bool Mesh::IsIndexed() const
+	{
+		return m_indexCount > 0;
+	}
 
-		// vertices.size() returns number of floats; m_vertexLayout.stride is in bytes.
-		// Convert float count to bytes before dividing by stride to get vertex count.
-		m_vertexCount = (vertices.size() * sizeof(float)) / static_cast<size_t>(m_vertexLayout.stride);
+	uint32_t Mesh::GetSortId() const
+	{
+		return m_sortId;
+	}
 
+	bool Mesh::HasBounds() const
+	{
+		return m_hasBounds;
 	}
 
-	void Mesh::Bind()
+	const AABB& Mesh::GetBounds() const
 	{
-		glBindVertexArray(m_VAO);
+		return m_bounds;
+	}
 
+	const BoundingSphere& Mesh::GetBoundingSphere() const
+	{
+		return m_boundingSphere;
 	}
 
-	void Mesh::Draw()
+	void Mesh::ComputeBounds(const uint8_t* vertexData)
 	{
-		if (m_indexCount > 0)
+		// Positions are the attribute bound to location 0, in any format VertexCompression decodes
+		const VertexElement* position = nullptr;
+		for (auto& element : m_vertexLayout.elements)
 		{
-			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), GL_UNSIGNED_INT, 0);
+			if (element.index == 0 && element.size >= 2 && VertexCompression::IsSupportedType(element.type))
+			{
+				position = &element;
+			}
 		}
-		else
+		if (!position || m_vertexCount == 0)
 		{
-			glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertexCount));
+			return; // Unknown extent, never culled
 		}
+
+		auto positionAt = [&](size_t vertex) {
+			const glm::vec4 p = VertexCompression::Decode(*position, vertexData + vertex * m_vertexLayout.stride);
+			return glm::vec3(p.x, p.y, position->size >= 3 ? p.z : 0.0f);
+		};
+
+		m_bounds = AABB{ positionAt(0), positionAt(0) };
+		for (size_t i = 1; i < m_vertexCount; ++i)
+		{
+			const glm::vec3 p = positionAt(i);
+			m_bounds.min = glm::min(m_bounds.min, p);
+			m_bounds.max = glm::max(m_bounds.max, p);
+		}
+
+		// Centered on the box; the farthest vertex gives a tighter radius than the box diagonal
+		float radiusSquared = 0.0f;
+		const glm::vec3 center = m_bounds.GetCenter();
+		for (size_t i = 0; i < m_vertexCount; ++i)
+		{
+			const glm::vec3 d = positionAt(i) - center;
+			radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+		}
+		m_boundingSphere = BoundingSphere{ center, std::sqrt(radiusSquared) };
+		m_hasBounds = true;
 	}
 }
-
@@ -1,28 +1,61 @@
 #pragma once
 #include <GL/glew.h>
 #include "Core/render/VertexLayout.hpp"
+#include "Core/render/GeometryPool.hpp"
+#include "Core/spatial/AABB.hpp"
+#include "Core/spatial/BoundingSphere.hpp"
 
 namespace LEN
 {
+	// Vertices and indices live in the GeometryPool of the mesh's layout; the mesh is a handle to
+	// its ranges there plus the CPU side bounds
 	class Mesh
 	{
 	public:
 		Mesh(const VertexLayout&, const std::vector<float>& vertices, const std::vector<uint32_t>& indices);
 		Mesh(const VertexLayout&, const std::vector<float>& vertices);
+		// Vertices in any layout VertexCompression can read, e.g. VertexCompression::Encode output
+		Mesh(const VertexLayout&, const std::vector<uint8_t>& vertexData, const std::vector<uint32_t>& indices);
 		Mesh(const Mesh&) = delete;
 		Mesh& operator = (const Mesh&) = delete;
+		~Mesh();
 
 		void Bind();
 		void Draw();
 
+		// Points the standard instance attributes (VertexLayout::InstanceTransform) of this mesh's pool
+		// at buffer + offset; binds the mesh. Skipped when they already point there.
+		void BindInstanceBuffer(GLuint buffer, size_t offset);
+		void DrawInstanced(uint32_t instanceCount); // After Bind and BindInstanceBuffer
+
+		// Local space bounds of the position attribute (location 0), computed once at construction
+		bool HasBounds() const;
+		const AABB& GetBounds() const;
+		const BoundingSphere& GetBoundingSphere() const;
+
+		uint32_t GetSortId() const; // Small unique id for render sort keys
+
+		// nullptr when headless; the range is looked up per draw, see GeometryPool::GetRange
+		GeometryPool* GetGeometryPool() const;
+		GeometryPool::Handle GetGeometryHandle() const;
+		bool IsIndexed() const;
+
 	private:
+		Mesh(const VertexLayout&, const void* vertexData, size_t vertexBytes, const std::vector<uint32_t>& indices);
+		void Upload(const void* vertexData, const std::vector<uint32_t>& indices); // Skipped when headless
+		void ComputeBounds(const uint8_t* vertexData);
+
 		VertexLayout m_vertexLayout;
-		GLuint m_VBO = 0; // Vertex Buffer Object
-		GLuint m_EBO = 0; // Element Buffer Object
-		GLuint m_VAO = 0; // Vertex Array Object
+		GeometryPool* m_pool = nullptr;
+		GeometryPool::Handle m_geometry = GeometryPool::InvalidHandle;
 
 		size_t m_vertexCount = 0;
 		size_t m_indexCount = 0;
+
+		AABB m_bounds;
+		BoundingSphere m_boundingSphere;
+		bool m_hasBounds = false;
+		uint32_t m_sortId = 0;
 	
 	};
 }
\ No newline at end of file
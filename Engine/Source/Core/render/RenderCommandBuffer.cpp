@@ -0,0 +1,92 @@
+#include "Core/render/RenderCommandBuffer.hpp"
+#include "Core/render/Material.hpp"
+#include "Core/render/Mesh.hpp"
+#include "Core/render/RenderSort.hpp"
+#include "Core/graphics/ShaderProgram.hpp"
+
+namespace LEN
+{
+	void RenderCommandBuffer::Draw(const RenderCommand& command)
+	{
+		const size_t chunk = m_drawCount / ChunkSize;
+		if (chunk == m_chunks.size())
+		{
+			m_chunks.push_back(std::make_unique<RenderCommand[]>(ChunkSize));
+		}
+
+		RenderCommand& recorded = m_chunks[chunk][m_drawCount % ChunkSize];
+		recorded = command;
+		const ShaderProgram* program = recorded.material->GetShaderProgram();
+		recorded.sortKey = RenderSort::MakeKey(recorded.layer, program ? program->GetSortId() : 0,
+			recorded.material->GetSortId(), recorded.mesh->GetSortId(), 0.0f);
+		++m_drawCount;
+	}
+
+	void RenderCommandBuffer::SetViewport(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t layer)
+	{
+		StateCommand command;
+		command.type = StateCommand::Type::Viewport;
+		command.layer = layer;
+		command.viewport[0] = x;
+		command.viewport[1] = y;
+		command.viewport[2] = width;
+		command.viewport[3] = height;
+		m_stateCommands.push_back(command);
+	}
+
+	void RenderCommandBuffer::Clear(const glm::vec4& color, bool clearColor, bool clearDepth, uint8_t layer)
+	{
+		StateCommand command;
+		command.type = StateCommand::Type::Clear;
+		command.layer = layer;
+		command.clearColor = clearColor;
+		command.clearDepth = clearDepth;
+		command.color[0] = color.x;
+		command.color[1] = color.y;
+		command.color[2] = color.z;
+		command.color[3] = color.w;
+		m_stateCommands.push_back(command);
+	}
+
+	void RenderCommandBuffer::Reset()
+	{
+		m_drawCount = 0;
+		m_stateCommands.clear();
+	}
+
+	void RenderCommandBuffer::Truncate(size_t drawCount)
+	{
+		m_drawCount = drawCount < m_drawCount ? drawCount : m_drawCount;
+	}
+
+	size_t RenderCommandBuffer::GetDrawCount() const
+	{
+		return m_drawCount;
+	}
+
+	size_t RenderCommandBuffer::GetChunkCount() const
+	{
+		return (m_drawCount + ChunkSize - 1) / ChunkSize;
+	}
+
+	RenderCommand* RenderCommandBuffer::GetChunk(size_t index)
+	{
+		return m_chunks[index].get();
+	}
+
+	const RenderCommand* RenderCommandBuffer::GetChunk(size_t index) const
+	{
+		return m_chunks[index].get();
+	}
+
+	size_t RenderCommandBuffer::GetChunkSize(size_t index) const
+	{
+		const size_t begin = index * ChunkSize;
+		return m_drawCount - begin < ChunkSize ? m_drawCount - begin : ChunkSize;
+	}
+
+	const std::vector<StateCommand>& RenderCommandBuffer::GetStateCommands() const
+	{
+		return m_stateCommands;
+	}
+}
\ No newline at end of file
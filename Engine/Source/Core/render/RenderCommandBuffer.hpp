@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include "Core/spatial/AABB.hpp"
+#include "Core/scene/TransformStore.hpp"
+
+namespace LEN
+{
+	class Mesh;
+	class Material;
+
+	struct RenderCommand
+	{
+		Mesh* mesh = nullptr;
+		Material* material = nullptr;
+		glm::mat4 modelMatrix;
+		AABB worldBounds; // Mesh bounds transformed by modelMatrix
+		bool hasBounds = false; // Commands without bounds are never culled
+		uint8_t layer = 0; // 0..15, layers are drawn in ascending order (see RenderSort)
+		uint64_t sortKey = 0; // Set when recorded, without the depth bits, which Prepare fills per frame
+
+		// Source of modelMatrix; lets retained commands be redrawn at an interpolated transform
+		const TransformStore* transforms = nullptr;
+		TransformId transformId = InvalidTransformId;
+		uint32_t transformGeneration = 0; // transformId may be reused once the object is destroyed
+	};
+	static_assert(std::is_trivially_copyable_v<RenderCommand>, "Render commands are copied as plain bytes");
+
+	// Pipeline state recorded next to the draws. A state command applies before the first draw of
+	// its layer and stays in effect for the rest of the frame; state commands of one layer run in
+	// recording order, threads merged in thread order.
+	struct StateCommand
+	{
+		enum class Type : uint8_t
+		{
+			Viewport, // viewport = x, y, width, height in pixels
+			Clear, // color when clearColor; depth buffer when clearDepth
+		};
+
+		Type type = Type::Viewport;
+		uint8_t layer = 0;
+		bool clearColor = false;
+		bool clearDepth = false;
+		int32_t viewport[4] = {};
+		float color[4] = {};
+	};
+	static_assert(std::is_trivially_copyable_v<StateCommand>, "Render commands are copied as plain bytes");
+
+	// Commands recorded by one thread during a frame, without locks. Draws live in fixed-size chunks
+	// that are kept across frames: recording never moves earlier entries and, once the chunks exist,
+	// never allocates. Get the calling thread's buffer from RenderQueue::GetThreadBuffer.
+	class RenderCommandBuffer
+	{
+	public:
+		static constexpr size_t ChunkSize = 1024; // Commands per chunk
+
+		RenderCommandBuffer() = default;
+		RenderCommandBuffer(RenderCommandBuffer&&) = default;
+		RenderCommandBuffer& operator=(RenderCommandBuffer&&) = default;
+
+		// Records a draw and computes the state part of its sort key (see RenderSort)
+		void Draw(const RenderCommand& command);
+		void SetViewport(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t layer = 0);
+		void Clear(const glm::vec4& color, bool clearColor, bool clearDepth, uint8_t layer = 0);
+
+		void Reset(); // Forgets the commands, keeps the chunks
+		void Truncate(size_t drawCount); // Keeps the first drawCount draws
+
+		size_t GetDrawCount() const;
+		size_t GetChunkCount() const; // Chunks holding commands this frame
+		RenderCommand* GetChunk(size_t index); // Full except for the last one
+		const RenderCommand* GetChunk(size_t index) const;
+		size_t GetChunkSize(size_t index) const; // Commands in the chunk
+		const std::vector<StateCommand>& GetStateCommands() const;
+
+	private:
+		std::vector<std::unique_ptr<RenderCommand[]>> m_chunks;
+		size_t m_drawCount = 0;
+		std::vector<StateCommand> m_stateCommands;
+	};
+}
\ No newline at end of file
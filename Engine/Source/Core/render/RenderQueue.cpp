@@ -3,29 +3,384 @@
 #include "Core/render/Material.hpp"
 #include "Core/graphics/GraphicsAPI.hpp"
 #include "Core/graphics/ShaderProgram.hpp"
+#include "Core/jobs/JobSystem.hpp"
+#include <algorithm>
 
 
 
 namespace LEN
 {
+	namespace
+	{
+		// Interned once; resolved to a UniformHandle per program, never hashed per draw
+		const StringId ModelUniform = StringId::Intern("uModel");
+		const StringId ViewUniform = StringId::Intern("uView");
+		const StringId ProjectionUniform = StringId::Intern("uProjection");
+	}
+
+	RenderQueue::RenderQueue() : m_threadBuffers(1)
+	{
+	}
+
 	void RenderQueue::Submit(const RenderCommand& command)
 	{
-		m_commands.push_back(command);
+		GetThreadBuffer().Draw(command);
 	}
 
-	void RenderQueue::Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData)
+	RenderCommandBuffer& RenderQueue::GetThreadBuffer()
 	{
-		for (auto& command : m_commands)
+		const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+		return m_threadBuffers[threadIndex < m_threadBuffers.size() ? threadIndex : 0];
+	}
+
+	void RenderQueue::Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData, float interpolation)
+	{
+		m_packet.releases.clear(); // The previous frame has been drawn
+		Prepare(m_packet, cameraData, interpolation);
+		Execute(graphicsAPI, m_packet);
+	}
+
+	void RenderQueue::Prepare(FramePacket& packet, const CameraData& cameraData, float interpolation)
+	{
+		if (m_retainCommands)
 		{
-			graphicsAPI.BindMaterial(command.material);
+			for (auto& buffer : m_threadBuffers)
+			{
+				// Commands whose object was destroyed after it submitted are dropped, in place and in
+				// order; its transform id may already belong to an object created since
+				size_t kept = 0;
+				for (size_t chunk = 0; chunk < buffer.GetChunkCount(); ++chunk)
+				{
+					RenderCommand* commands = buffer.GetChunk(chunk);
+					for (size_t i = 0; i < buffer.GetChunkSize(chunk); ++i)
+					{
+						RenderCommand& command = commands[i];
+						if (command.transforms)
+						{
+							if (!command.transforms->IsValid(command.transformId, command.transformGeneration))
+							{
+								continue;
+							}
+							command.modelMatrix = command.transforms->GetInterpolatedWorldMatrix(command.transformId, interpolation);
+							if (command.hasBounds)
+							{
+								command.worldBounds = AABB::Transform(command.mesh->GetBounds(), command.modelMatrix);
+							}
+						}
+						const size_t index = chunk * RenderCommandBuffer::ChunkSize + i;
+						if (kept != index)
+						{
+							buffer.GetChunk(kept / RenderCommandBuffer::ChunkSize)[kept % RenderCommandBuffer::ChunkSize] = command;
+						}
+						++kept;
+					}
+				}
+				buffer.Truncate(kept);
+			}
+		}
+
+		packet.camera = cameraData;
+		m_culler.SetFrustum(Frustum::FromMatrix(cameraData.projectionMatrix * cameraData.viewMatrix));
+		packet.commands.clear();
+		packet.stateCommands.clear();
+		// Every chunk of every thread in one culling dispatch, so the job system splits the whole frame
+		m_cullSpans.clear();
+		for (auto& buffer : m_threadBuffers)
+		{
+			for (size_t chunk = 0; chunk < buffer.GetChunkCount(); ++chunk)
+			{
+				m_cullSpans.push_back(FrustumCuller::Span{ buffer.GetChunk(chunk), buffer.GetChunkSize(chunk) });
+			}
+		}
+		m_culler.Cull(m_cullSpans, packet.commands);
+		for (auto& buffer : m_threadBuffers)
+		{
+			const auto& stateCommands = buffer.GetStateCommands();
+			packet.stateCommands.insert(packet.stateCommands.end(), stateCommands.begin(), stateCommands.end());
+		}
+		std::stable_sort(packet.stateCommands.begin(), packet.stateCommands.end(),
+			[](const StateCommand& a, const StateCommand& b) { return a.layer < b.layer; });
+		Sort(packet);
+		BuildBatches(packet);
+
+		// Retained commands outlive this frame, their resources are only handed over after Clear
+		if (!m_retainCommands)
+		{
+			Clear();
+		}
+		for (auto& resource : m_releasable)
+		{
+			packet.releases.push_back(std::move(resource));
+		}
+		m_releasable.clear();
+	}
+
+	void RenderQueue::Sort(FramePacket& packet)
+	{
+		const size_t count = packet.commands.size();
+		packet.drawOrder.resize(count);
+		if (!m_sortEnabled)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				packet.drawOrder[i] = static_cast<uint32_t>(i);
+			}
+			return;
+		}
+
+		// View space z of the bounds center, or of the origin without bounds; the camera looks down -z
+		const glm::mat4& view = packet.camera.viewMatrix;
+		m_sortItems.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const RenderCommand& command = packet.commands[i];
+			const glm::vec3 position = command.hasBounds ? command.worldBounds.GetCenter() : glm::vec3(command.modelMatrix[3]);
+			const float viewZ = view[0][2] * position.x + view[1][2] * position.y + view[2][2] * position.z + view[3][2];
+			m_sortItems[i].key = command.sortKey | RenderSort::QuantizeDepth(-viewZ);
+			m_sortItems[i].index = static_cast<uint32_t>(i);
+		}
+		RenderSort::Sort(m_sortItems, m_sortScratch);
+
+		// Only the indices move; the commands stay where culling wrote them
+		for (size_t i = 0; i < count; ++i)
+		{
+			packet.drawOrder[i] = m_sortItems[i].index;
+		}
+	}
+
+	void RenderQueue::BuildBatches(FramePacket& packet)
+	{
+		packet.batches.clear();
+		packet.instances.clear();
+		packet.materials.clear();
+		packet.materialValues.clear();
+		packet.materialTextures.clear();
+		m_materialSlots.clear();
+		const uint32_t count = static_cast<uint32_t>(packet.drawOrder.size());
+		uint32_t first = 0;
+		while (first < count)
+		{
+			const RenderCommand& command = packet.commands[packet.drawOrder[first]];
+			const ShaderProgram* program = command.material->GetShaderProgram();
+
+			DrawBatch batch;
+			batch.first = first;
+			batch.instanced = program && program->IsInstanced();
+
+			// Sorting made equal mesh and material adjacent
+			uint32_t end = first + 1;
+			if (!batch.instanced || m_instancingEnabled)
+			{
+				while (end < count)
+				{
+					const RenderCommand& next = packet.commands[packet.drawOrder[end]];
+					if (next.mesh != command.mesh || next.material != command.material)
+					{
+						break;
+					}
+					++end;
+				}
+			}
+			batch.count = end - first;
+
+			// Parameters are copied here on the main thread, once per material and frame
+			auto slot = m_materialSlots.try_emplace(command.material, static_cast<uint32_t>(packet.materials.size()));
+			if (slot.second)
+			{
+				packet.materials.push_back(command.material->Capture(packet.materialValues, packet.materialTextures));
+			}
+			batch.material = slot.first->second;
+
+			if (batch.instanced)
+			{
+				batch.firstInstance = static_cast<uint32_t>(packet.instances.size());
+				for (uint32_t i = first; i < end; ++i)
+				{
+					packet.instances.push_back(packet.commands[packet.drawOrder[i]].modelMatrix);
+				}
+			}
+			packet.batches.push_back(batch);
+			first = end;
+		}
+	}
+
+	void RenderQueue::Execute(GraphicsAPI& graphicsAPI, const FramePacket& packet)
+	{
+		const CameraData& cameraData = packet.camera;
+		FrameUniforms frameUniforms;
+		frameUniforms.view = cameraData.viewMatrix;
+		frameUniforms.projection = cameraData.projectionMatrix;
+		frameUniforms.viewProjection = cameraData.projectionMatrix * cameraData.viewMatrix;
+		frameUniforms.viewport = cameraData.viewport;
+		frameUniforms.time = packet.time;
+		frameUniforms.deltaTime = packet.deltaTime;
+		graphicsAPI.UpdateFrameUniforms(frameUniforms);
+
+		GLuint instanceBuffer = 0;
+		size_t instanceOffset = 0;
+		if (!packet.instances.empty())
+		{
+			instanceBuffer = graphicsAPI.UploadInstanceData(packet.instances.data(), packet.instances.size() * sizeof(glm::mat4), instanceOffset);
+		}
+
+		Material* boundMaterial = nullptr;
+		ShaderProgram* boundProgram = nullptr;
+		Mesh* boundMesh = nullptr;
+		size_t nextState = 0;
+		const bool multiDraw = graphicsAPI.SupportsMultiDrawIndirect();
+		std::vector<DrawElementsIndirectCommand>& indirectCommands = graphicsAPI.GetIndirectScratch();
+		for (size_t batchIndex = 0; batchIndex < packet.batches.size(); ++batchIndex)
+		{
+			const DrawBatch& batch = packet.batches[batchIndex];
+			const RenderCommand& command = packet.commands[packet.drawOrder[batch.first]];
+			while (nextState < packet.stateCommands.size() && packet.stateCommands[nextState].layer <= command.layer)
+			{
+				graphicsAPI.ApplyStateCommand(packet.stateCommands[nextState++]);
+			}
+			if (command.material != boundMaterial)
+			{
+				graphicsAPI.BindMaterial(packet.materials[batch.material], packet.materialValues.data(), packet.materialTextures.data());
+				boundMaterial = command.material;
+			}
 			auto shaderProgram = command.material->GetShaderProgram();
-			shaderProgram->SetUniform("uModel", command.modelMatrix);
-			shaderProgram->SetUniform("uView", cameraData.viewMatrix);
-			shaderProgram->SetUniform("uProjection", cameraData.projectionMatrix);
-			graphicsAPI.BindMesh(command.mesh);
-			graphicsAPI.DrawMesh(command.mesh);
+			if (shaderProgram != boundProgram)
+			{
+				// Uniforms are program state, the camera stays set while the program does not change
+				if (!shaderProgram->UsesFrameUniforms())
+				{
+					shaderProgram->SetUniform(shaderProgram->FindUniform(ViewUniform), cameraData.viewMatrix);
+					shaderProgram->SetUniform(shaderProgram->FindUniform(ProjectionUniform), cameraData.projectionMatrix);
+				}
+				boundProgram = shaderProgram;
+			}
+			if (command.mesh != boundMesh)
+			{
+				graphicsAPI.BindMesh(command.mesh);
+				boundMesh = command.mesh;
+			}
+
+			// Instanced batches of one material and layer whose meshes share a pool: one multi-draw
+			GeometryPool* pool = command.mesh->GetGeometryPool();
+			if (batch.instanced && multiDraw && pool && command.mesh->IsIndexed())
+			{
+				indirectCommands.clear();
+				size_t last = batchIndex;
+				for (size_t next = batchIndex; next < packet.batches.size(); ++next)
+				{
+					const DrawBatch& run = packet.batches[next];
+					const RenderCommand& runCommand = packet.commands[packet.drawOrder[run.first]];
+					if (!run.instanced || runCommand.material != command.material || runCommand.layer != command.layer ||
+						runCommand.mesh->GetGeometryPool() != pool || !runCommand.mesh->IsIndexed())
+					{
+						break;
+					}
+					const GeometryPool::Range range = pool->GetRange(runCommand.mesh->GetGeometryHandle());
+					DrawElementsIndirectCommand indirect;
+					indirect.count = range.indexCount;
+					indirect.instanceCount = run.count;
+					indirect.firstIndex = range.indexOffset;
+					indirect.baseVertex = static_cast<int32_t>(range.vertexOffset);
+					indirect.baseInstance = run.firstInstance;
+					indirectCommands.push_back(indirect);
+					last = next;
+				}
+				graphicsAPI.DrawMultiIndirect(pool, indirectCommands.data(), static_cast<uint32_t>(indirectCommands.size()),
+					instanceBuffer, instanceOffset);
+				boundMesh = packet.commands[packet.drawOrder[packet.batches[last].first]].mesh;
+				batchIndex = last;
+				continue;
+			}
+			if (batch.instanced)
+			{
+				graphicsAPI.DrawMeshInstanced(command.mesh, instanceBuffer, instanceOffset + batch.firstInstance * sizeof(glm::mat4), batch.count);
+				continue;
+			}
+			// Resolved once per batch; optional, a program may not use uModel
+			const UniformHandle modelHandle = shaderProgram->FindUniform(ModelUniform);
+			for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+			{
+				shaderProgram->SetUniform(modelHandle, packet.commands[packet.drawOrder[i]].modelMatrix);
+				graphicsAPI.DrawMesh(command.mesh);
+			}
+		}
+
+		// State of layers without draws, e.g. a final clear
+		while (nextState < packet.stateCommands.size())
+		{
+			graphicsAPI.ApplyStateCommand(packet.stateCommands[nextState++]);
+		}
+	}
+
+	void RenderQueue::ReleaseAfterDraw(std::shared_ptr<void> resource)
+	{
+		if (resource)
+		{
+			m_pendingReleases.push_back(std::move(resource));
+		}
+	}
+
+	void RenderQueue::SetThreadCount(uint32_t threadCount)
+	{
+		m_threadBuffers.resize(threadCount > 0 ? threadCount : 1);
+	}
+
+	void RenderQueue::SetRetainCommands(bool retain)
+	{
+		m_retainCommands = retain;
+	}
+
+	void RenderQueue::Clear()
+	{
+		for (auto& buffer : m_threadBuffers)
+		{
+			buffer.Reset();
+		}
+
+		// Nothing submitted references them any more; the next packet keeps them until it is drawn
+		for (auto& resource : m_pendingReleases)
+		{
+			m_releasable.push_back(std::move(resource));
 		}
+		m_pendingReleases.clear();
+	}
+
+	void RenderQueue::SetJobSystem(JobSystem* jobSystem)
+	{
+		m_culler.SetJobSystem(jobSystem);
+	}
+
+	void RenderQueue::SetSortEnabled(bool enabled)
+	{
+		m_sortEnabled = enabled;
+	}
+
+	bool RenderQueue::IsSortEnabled() const
+	{
+		return m_sortEnabled;
+	}
+
+	void RenderQueue::SetInstancingEnabled(bool enabled)
+	{
+		m_instancingEnabled = enabled;
+	}
+
+	bool RenderQueue::IsInstancingEnabled() const
+	{
+		return m_instancingEnabled;
+	}
+
+	FrustumCuller& RenderQueue::GetCuller()
+	{
+		return m_culler;
+	}
+
+	size_t RenderQueue::GetVisibleCount() const
+	{
+		return m_culler.GetVisibleCount();
+	}
 
-		m_commands.clear();
+	size_t RenderQueue::GetCulledCount() const
+	{
+		return m_culler.GetCulledCount();
 	}
 }
\ No newline at end of file
@@ -1,6 +1,16 @@
 #pragma once
 #include <vector>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include "Core/spatial/AABB.hpp"
+#include "Core/render/FrustumCuller.hpp"
+#include "Core/render/Material.hpp"
+#include "Core/render/RenderCommandBuffer.hpp"
+#include "Core/render/RenderSort.hpp"
+#include "Core/scene/TransformStore.hpp"
 
 
 namespace LEN
@@ -8,27 +18,105 @@ namespace LEN
 	class Mesh;
 	class Material;
 	class GraphicsAPI;
+	class JobSystem;
 
-	struct RenderCommand
-	{
-		Mesh* mesh = nullptr;
-		Material* material = nullptr;
-		glm::mat4 modelMatrix;
+	struct CameraData {
+		glm::mat4 viewMatrix = glm::mat4(1.0f);
+		glm::mat4 projectionMatrix = glm::mat4(1.0f);
+		glm::vec4 viewport = glm::vec4(0.0f); // x, y, width, height in pixels
 	};
 
-	struct CameraData {
-		glm::mat4 viewMatrix;
-		glm::mat4 projectionMatrix;
+	// Consecutive entries of FramePacket::drawOrder sharing mesh and material
+	struct DrawBatch {
+		uint32_t first = 0; // Into drawOrder
+		uint32_t count = 0;
+		uint32_t firstInstance = 0; // Into FramePacket::instances when instanced
+		bool instanced = false; // One instanced draw; otherwise one draw per command with uModel
+		uint32_t material = 0; // Into FramePacket::materials
+	};
+
+	// Everything needed to draw one frame, built by RenderQueue::Prepare. Once handed to the render
+	// thread it is only read; the simulation does not touch it until the frame has been drawn.
+	struct FramePacket {
+		CameraData camera;
+		float time = 0.0f; // Seconds of simulated time, for FrameUniforms
+		float deltaTime = 0.0f;
+		std::vector<RenderCommand> commands; // Visible commands in submission order
+		std::vector<StateCommand> stateCommands; // By layer, then in recording order
+		std::vector<uint32_t> drawOrder; // Indices into commands, sorted by RenderSort key
+		std::vector<DrawBatch> batches; // Cover drawOrder in order
+		std::vector<glm::mat4> instances; // Model matrices of the instanced batches, uploaded once per frame
+		std::vector<MaterialSnapshot> materials; // One per material drawn, parameters as of Prepare
+		std::vector<std::byte> materialValues;
+		std::vector<GLuint> materialTextures;
+		std::vector<std::shared_ptr<void>> releases; // Released when the packet is reused, see RenderQueue::ReleaseAfterDraw
 	};
 
 	class RenderQueue
 	{
 	public:
-		void Submit(const RenderCommand& command); // Submit a render command to the queue
-		void Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData); // Draw all submitted commands
+		RenderQueue();
+
+		// Submit a render command to the queue. Safe to call from any job system thread:
+		// each thread records into its own buffer, merged in thread order by Prepare. The state part
+		// of the sort key is computed here, so it is spread over the submitting threads.
+		void Submit(const RenderCommand& command);
+		// The calling thread's buffer, for recording draws and state without looking it up per command.
+		// Only used by that thread until the frame is prepared.
+		RenderCommandBuffer& GetThreadBuffer();
+		// Prepare followed by Execute on the calling thread
+		void Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData, float interpolation = 1.0f);
+		// Cull the submitted commands into packet, sorted by RenderSort key and grouped into draw batches:
+		// runs of equal mesh and material with an instanced shader (ShaderProgram::IsInstanced) become
+		// one instanced draw. With retained commands the model matrices are re-read
+		// from their TransformStore, blended by interpolation (see TransformStore::GetInterpolatedWorldMatrix).
+		// Needs no GL context.
+		void Prepare(FramePacket& packet, const CameraData& cameraData, float interpolation = 1.0f);
+		// Issue the GL calls of a prepared packet; on the thread owning the context. The camera goes
+		// to the frame uniform buffer once; programs without the FrameUniforms block get it as uView
+		// and uProjection. Material and mesh are only rebound when they differ from the previous batch.
+		static void Execute(GraphicsAPI& graphicsAPI, const FramePacket& packet);
+
+		// Keeps resource alive until no submitted command and no frame in flight can reference it.
+		// For owners of meshes and materials destroyed while their commands may still be drawn. Main thread only.
+		void ReleaseAfterDraw(std::shared_ptr<void> resource);
+
+		// Keep the submitted commands across Draw calls until Clear. Used by fixed-step simulation,
+		// where frames without a simulation tick redraw the last tick's commands.
+		void SetRetainCommands(bool retain);
+		void Clear();
+
+		void SetThreadCount(uint32_t threadCount); // Called by the engine to match the job system
+		void SetJobSystem(JobSystem* jobSystem); // Used to split culling across threads
+
+		// Off: draw in submission order (thread lists merged in thread order), for debugging
+		void SetSortEnabled(bool enabled);
+		bool IsSortEnabled() const;
+
+		// Off: every command of an instanced shader is its own single instance draw, for comparison
+		void SetInstancingEnabled(bool enabled);
+		bool IsInstancingEnabled() const;
+
+		FrustumCuller& GetCuller();
+		size_t GetVisibleCount() const; // Commands drawn by the last Draw
+		size_t GetCulledCount() const; // Commands rejected by the last Draw
 		
 	private:
-		std::vector<RenderCommand> m_commands;
+		void Sort(FramePacket& packet); // Fills packet.drawOrder
+		void BuildBatches(FramePacket& packet); // Fills packet.batches and packet.instances from drawOrder
+
+		std::vector<RenderCommandBuffer> m_threadBuffers; // Indexed by JobSystem::GetCurrentThreadIndex()
+		std::vector<FrustumCuller::Span> m_cullSpans; // Chunks of m_threadBuffers in thread order
+		FramePacket m_packet; // Used by Draw
+		std::vector<RenderSort::Item> m_sortItems;
+		std::vector<RenderSort::Item> m_sortScratch;
+		std::unordered_map<const Material*, uint32_t> m_materialSlots; // Into FramePacket::materials, per Prepare
+		bool m_sortEnabled = true;
+		bool m_instancingEnabled = true;
+		std::vector<std::shared_ptr<void>> m_pendingReleases; // May still be referenced by submitted commands
+		std::vector<std::shared_ptr<void>> m_releasable; // Go to the next prepared packet
+		FrustumCuller m_culler;
+		bool m_retainCommands = false;
 	
 	};
 }
\ No newline at end of file
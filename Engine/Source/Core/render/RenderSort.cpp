@@ -0,0 +1,95 @@
+#include "Core/render/RenderSort.hpp"
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace LEN::RenderSort
+{
+	uint64_t MakeKey(uint32_t layer, uint32_t program, uint32_t material, uint32_t mesh, float depth)
+	{
+		return (static_cast<uint64_t>(layer & 0xF) << 60)
+			| (static_cast<uint64_t>(program & 0xFFF) << 48)
+			| (static_cast<uint64_t>(material & 0xFFFF) << 32)
+			| (static_cast<uint64_t>(mesh & 0xFFFF) << 16)
+			| QuantizeDepth(depth);
+	}
+
+	uint16_t QuantizeDepth(float depth)
+	{
+		// Positive floats order like their bit patterns; the top 16 bits keep sign, exponent and
+		// 7 mantissa bits. NaN is not > 0 and lands at 0 as well.
+		if (!(depth > 0.0f))
+		{
+			return 0;
+		}
+		return static_cast<uint16_t>(std::bit_cast<uint32_t>(depth) >> 16);
+	}
+
+	void Sort(std::vector<Item>& items, std::vector<Item>& scratch)
+	{
+		const size_t count = items.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		// Bits that differ between keys; bytes outside them need no pass (and no histogram, where
+		// every key would bump the same counter)
+		uint64_t anyBits = 0;
+		uint64_t allBits = ~uint64_t(0);
+		for (const Item& item : items)
+		{
+			anyBits |= item.key;
+			allBits &= item.key;
+		}
+		const uint64_t varying = anyBits ^ allBits;
+
+		std::array<uint32_t, 8> passBytes{};
+		size_t passCount = 0;
+		for (uint32_t byte = 0; byte < 8; ++byte)
+		{
+			if ((varying >> (byte * 8)) & 0xFF)
+			{
+				passBytes[passCount++] = byte;
+			}
+		}
+
+		// Histograms of all passes in one read of the keys
+		std::array<std::array<uint32_t, 256>, 8> histograms{};
+		for (const Item& item : items)
+		{
+			for (size_t pass = 0; pass < passCount; ++pass)
+			{
+				++histograms[pass][(item.key >> (passBytes[pass] * 8)) & 0xFF];
+			}
+		}
+
+		scratch.resize(count);
+		Item* source = items.data();
+		Item* target = scratch.data();
+		for (size_t pass = 0; pass < passCount; ++pass)
+		{
+			// Exclusive prefix sum: start of each bucket
+			auto& histogram = histograms[pass];
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram)
+			{
+				const uint32_t size = bucket;
+				bucket = offset;
+				offset += size;
+			}
+
+			const uint32_t shift = passBytes[pass] * 8;
+			for (size_t i = 0; i < count; ++i)
+			{
+				target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+			}
+			std::swap(source, target);
+		}
+
+		if (source != items.data())
+		{
+			std::memcpy(items.data(), source, count * sizeof(Item));
+		}
+	}
+}
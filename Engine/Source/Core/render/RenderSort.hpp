@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace LEN
+{
+	/************************************************************************
+	 *                           RENDER SORT KEY                              *
+	 *  63..60  layer             RenderCommand::layer, drawn ascending      *
+	 *  59..48  shader program    ShaderProgram::GetSortId                   *
+	 *  47..32  material          Material::GetSortId                        *
+	 *  31..16  mesh              Mesh::GetSortId                            *
+	 *  15..0   depth             view depth, near first                     *
+	 *  State changes are ordered by cost, so equal programs, then equal     *
+	 *  materials and meshes end up adjacent; depth only orders draws that   *
+	 *  share all of them (front to back for early depth rejection). Ids     *
+	 *  wrap at their field width: a collision only costs batching.          *
+	 ************************************************************************/
+	namespace RenderSort
+	{
+		struct Item
+		{
+			uint64_t key;
+			uint32_t index; // Into FramePacket::commands
+		};
+
+		uint64_t MakeKey(uint32_t layer, uint32_t program, uint32_t material, uint32_t mesh, float depth);
+		uint16_t QuantizeDepth(float depth); // Monotonic, relative precision like a float; <= 0 maps to 0
+
+		// Stable ascending LSD radix sort on Item::key, one pass per key byte; bytes equal in every
+		// key are skipped. scratch is resized as needed and can be kept between frames.
+		void Sort(std::vector<Item>& items, std::vector<Item>& scratch);
+	}
+}
@@ -0,0 +1,216 @@
+#include "Core/render/RenderThread.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace LEN
+{
+	RenderThread::~RenderThread()
+	{
+		Stop();
+	}
+
+	void RenderThread::Start(uint32_t depth, Callbacks callbacks)
+	{
+		if (m_running)
+		{
+			return;
+		}
+
+		m_callbacks = std::move(callbacks);
+		m_packets.clear();
+		m_packets.resize(std::max(depth, 1u) + 1);
+		m_published = 0;
+		m_drawn = 0;
+		m_stopping = false;
+		m_running = true;
+
+		// Held until the id is stored, the thread reads it under the same lock
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_thread = std::thread(&RenderThread::ThreadMain, this);
+		m_threadId = m_thread.get_id();
+	}
+
+	void RenderThread::Stop()
+	{
+		if (!m_running)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+		m_threadId = std::thread::id();
+		m_running = false;
+	}
+
+	void RenderThread::ReleaseFrames()
+	{
+		assert(!m_running);
+		m_packets.clear();
+	}
+
+	bool RenderThread::IsRunning() const
+	{
+		return m_running;
+	}
+
+	bool RenderThread::IsRenderThread() const
+	{
+		return m_running && std::this_thread::get_id() == m_threadId;
+	}
+
+	FramePacket& RenderThread::BeginFrame()
+	{
+		assert(m_running && !IsRenderThread());
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_progress.wait(lock, [this]() { return m_published - m_drawn < m_packets.size(); });
+		}
+
+		// Drawn, so its releases can go; they run their destructors here on the main thread
+		FramePacket& packet = m_packets[m_published % m_packets.size()];
+		packet.commands.clear();
+		packet.stateCommands.clear();
+		packet.drawOrder.clear();
+		packet.batches.clear();
+		packet.instances.clear();
+		packet.materials.clear();
+		packet.materialValues.clear();
+		packet.materialTextures.clear();
+		packet.releases.clear();
+		return packet;
+	}
+
+	void RenderThread::EndFrame()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_published;
+		}
+		m_wake.notify_one();
+	}
+
+	void RenderThread::Flush()
+	{
+		if (!m_running || IsRenderThread())
+		{
+			return;
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_progress.wait(lock, [this]() { return m_drawn == m_published; });
+	}
+
+	void RenderThread::Execute(const std::function<void()>& work)
+	{
+		if (!m_running || IsRenderThread())
+		{
+			work();
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_immediate.push_back(&work);
+		const uint64_t ticket = ++m_immediateQueued;
+		m_wake.notify_one();
+		m_progress.wait(lock, [&]() { return m_immediateDone >= ticket; });
+	}
+
+	void RenderThread::Enqueue(std::function<void()> work)
+	{
+		if (!m_running)
+		{
+			work();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_deferred.push_back(DeferredWork{ m_published, std::move(work) });
+		}
+		m_wake.notify_one();
+	}
+
+	uint64_t RenderThread::GetPublishedFrameCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_published;
+	}
+
+	uint64_t RenderThread::GetDrawnFrameCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_drawn;
+	}
+
+	bool RenderThread::HasWork() const
+	{
+		return !m_immediate.empty()
+			|| (!m_deferred.empty() && m_deferred.front().fence <= m_drawn)
+			|| m_published > m_drawn;
+	}
+
+	void RenderThread::ThreadMain()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex); // Wait for Start to publish m_threadId
+		}
+		if (m_callbacks.attach)
+		{
+			m_callbacks.attach();
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true)
+		{
+			m_wake.wait(lock, [this]() { return HasWork() || m_stopping; });
+
+			// Blocking work first: the main thread is waiting on it
+			while (!m_immediate.empty())
+			{
+				const std::function<void()>* work = m_immediate.front();
+				m_immediate.pop_front();
+				lock.unlock();
+				(*work)();
+				lock.lock();
+				++m_immediateDone;
+				m_progress.notify_all();
+			}
+
+			while (!m_deferred.empty() && m_deferred.front().fence <= m_drawn)
+			{
+				auto work = std::move(m_deferred.front().work);
+				m_deferred.pop_front();
+				lock.unlock();
+				work();
+				lock.lock();
+			}
+
+			if (m_published > m_drawn)
+			{
+				const FramePacket& packet = m_packets[m_drawn % m_packets.size()];
+				lock.unlock();
+				m_callbacks.render(packet);
+				lock.lock();
+				++m_drawn;
+				m_progress.notify_all();
+				continue;
+			}
+
+			// Every frame is drawn, so every deferred fence has been reached
+			if (m_stopping && m_immediate.empty() && m_deferred.empty())
+			{
+				break;
+			}
+		}
+		lock.unlock();
+
+		if (m_callbacks.detach)
+		{
+			m_callbacks.detach();
+		}
+	}
+}
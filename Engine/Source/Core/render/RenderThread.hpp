@@ -0,0 +1,93 @@
+#pragma once
+#include "Core/render/RenderQueue.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LEN
+{
+	/************************************************************************
+	 *                        RENDER THREAD CONTRACT                          *
+	 *  The render thread owns the GL context while it runs. The main thread *
+	 *  fills a FramePacket between BeginFrame and EndFrame; the render      *
+	 *  thread draws published packets in order while the main thread       *
+	 *  simulates the next frame. With pipeline depth N up to N frames are   *
+	 *  published but not yet drawn: 1 = double buffering, 2 = triple.      *
+	 *   - Packets are immutable once published and are reused (and their   *
+	 *     releases dropped, on the main thread) only after being drawn.     *
+	 *   - Meshes, materials and shader programs referenced by a published  *
+	 *     packet must not be modified or destroyed until it is drawn: use   *
+	 *     RenderQueue::ReleaseAfterDraw, or Flush before editing them.      *
+	 *     Material parameters and textures are the exception: Prepare     *
+	 *     copies them into the packet, SetParam may run at any time.        *
+	 *   - Any other GL call goes through Execute (blocking) or Enqueue.     *
+	 ************************************************************************/
+	class RenderThread
+	{
+	public:
+		struct Callbacks
+		{
+			std::function<void()> attach; // On the render thread before the first frame, e.g. make the context current
+			std::function<void()> detach; // On the render thread after the last frame
+			std::function<void(const FramePacket&)> render; // Draws and presents one frame
+		};
+
+		RenderThread() = default;
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+		~RenderThread();
+
+		void Start(uint32_t depth, Callbacks callbacks);
+		// Draws the frames still published, runs the pending work and joins. Packets keep their
+		// releases until ReleaseFrames, so they can be dropped once the caller owns the context again.
+		void Stop();
+		void ReleaseFrames();
+		bool IsRunning() const;
+		bool IsRenderThread() const; // True on the render thread itself
+
+		FramePacket& BeginFrame(); // Waits until a packet is free
+		void EndFrame(); // Publishes the packet returned by BeginFrame
+		void Flush(); // Waits until every published frame has been drawn
+
+		// Runs work on the render thread before its next frame and waits for it; inline on the
+		// render thread itself
+		void Execute(const std::function<void()>& work);
+		// Runs work on the render thread after the frames published so far, without waiting.
+		// For releasing GL objects those frames may still use.
+		void Enqueue(std::function<void()> work);
+
+		uint64_t GetPublishedFrameCount() const;
+		uint64_t GetDrawnFrameCount() const;
+
+	private:
+		struct DeferredWork
+		{
+			uint64_t fence; // Runs once this many frames have been drawn
+			std::function<void()> work;
+		};
+
+		void ThreadMain();
+		bool HasWork() const; // Caller holds m_mutex
+
+		Callbacks m_callbacks;
+		std::vector<FramePacket> m_packets; // Ring of depth + 1
+		uint64_t m_published = 0;
+		uint64_t m_drawn = 0;
+		std::deque<const std::function<void()>*> m_immediate; // Owned by the waiting Execute callers
+		uint64_t m_immediateDone = 0;
+		uint64_t m_immediateQueued = 0;
+		std::deque<DeferredWork> m_deferred; // Fences never decrease
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_wake; // Render thread: frame published, work queued or stop
+		std::condition_variable m_progress; // Main thread: frame drawn or work done
+		std::thread m_thread;
+		std::thread::id m_threadId;
+		bool m_running = false;
+		bool m_stopping = false;
+	};
+}
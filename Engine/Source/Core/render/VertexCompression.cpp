@@ -0,0 +1,335 @@
+#include "Core/render/VertexCompression.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace LEN
+{
+	namespace VertexCompression
+	{
+		namespace
+		{
+			struct Format
+			{
+				GLenum type;
+				bool normalized;
+			};
+
+			uint32_t AlignUp(uint32_t value)
+			{
+				return (value + 3) & ~uint32_t(3);
+			}
+
+			uint32_t GetTypeSize(GLenum type)
+			{
+				switch (type)
+				{
+				case GL_BYTE:
+				case GL_UNSIGNED_BYTE:
+					return 1;
+				case GL_SHORT:
+				case GL_UNSIGNED_SHORT:
+				case GL_HALF_FLOAT:
+					return 2;
+				default:
+					return 4;
+				}
+			}
+
+			// Smallest first; the first one within budget is taken
+			std::vector<Format> GetCandidates(VertexSemantic semantic, uint32_t components)
+			{
+				switch (semantic)
+				{
+				case VertexSemantic::Normal:
+					if (components == 3)
+					{
+						return { { GL_INT_2_10_10_10_REV, true }, { GL_SHORT, true }, { GL_FLOAT, false } };
+					}
+					return { { GL_SHORT, true }, { GL_FLOAT, false } };
+				case VertexSemantic::Color:
+					return { { GL_UNSIGNED_BYTE, true }, { GL_UNSIGNED_SHORT, true }, { GL_HALF_FLOAT, false }, { GL_FLOAT, false } };
+				case VertexSemantic::TexCoord:
+					return { { GL_UNSIGNED_SHORT, true }, { GL_HALF_FLOAT, false }, { GL_FLOAT, false } };
+				default:
+					return { { GL_HALF_FLOAT, false }, { GL_FLOAT, false } };
+				}
+			}
+
+			float GetBudget(VertexSemantic semantic, const VertexErrorBudget& budget)
+			{
+				switch (semantic)
+				{
+				case VertexSemantic::Position: return budget.position;
+				case VertexSemantic::Normal: return budget.normal;
+				case VertexSemantic::Color: return budget.color;
+				case VertexSemantic::TexCoord: return budget.texCoord;
+				default: return budget.generic;
+				}
+			}
+
+			template<typename T>
+			void Store(uint8_t* out, uint32_t component, T value)
+			{
+				std::memcpy(out + component * sizeof(T), &value, sizeof(T));
+			}
+
+			template<typename T>
+			T Load(const uint8_t* in, uint32_t component)
+			{
+				T value;
+				std::memcpy(&value, in + component * sizeof(T), sizeof(T));
+				return value;
+			}
+
+			int32_t Quantize(float value, float low, float scale)
+			{
+				return static_cast<int32_t>(std::lround(std::clamp(value, low, 1.0f) * scale));
+			}
+
+			void EncodeElement(const Format& format, uint32_t components, const float* values, uint8_t* out)
+			{
+				if (format.type == GL_INT_2_10_10_10_REV)
+				{
+					uint32_t packed = 0;
+					for (uint32_t i = 0; i < std::min(components, 3u); ++i)
+					{
+						packed |= (static_cast<uint32_t>(Quantize(values[i], -1.0f, 511.0f)) & 0x3FF) << (10 * i);
+					}
+					Store(out, 0, packed); // w stays 0
+					return;
+				}
+				for (uint32_t i = 0; i < components; ++i)
+				{
+					switch (format.type)
+					{
+					case GL_UNSIGNED_BYTE: Store(out, i, static_cast<uint8_t>(Quantize(values[i], 0.0f, 255.0f))); break;
+					case GL_UNSIGNED_SHORT: Store(out, i, static_cast<uint16_t>(Quantize(values[i], 0.0f, 65535.0f))); break;
+					case GL_SHORT: Store(out, i, static_cast<int16_t>(Quantize(values[i], -1.0f, 32767.0f))); break;
+					case GL_HALF_FLOAT: Store(out, i, FloatToHalf(values[i])); break;
+					default: Store(out, i, values[i]); break;
+					}
+				}
+			}
+		}
+
+		EncodedVertices Encode(const VertexLayout& layout, const std::vector<float>& vertices,
+			const std::vector<VertexSemantic>& semantics, const VertexErrorBudget& budget)
+		{
+			EncodedVertices encoded;
+			if (layout.stride == 0)
+			{
+				return encoded;
+			}
+			const size_t vertexCount = vertices.size() * sizeof(float) / layout.stride;
+			const uint8_t* source = reinterpret_cast<const uint8_t*>(vertices.data());
+
+			std::vector<Format> formats;
+			uint32_t offset = 0;
+			for (size_t e = 0; e < layout.elements.size(); ++e)
+			{
+				const VertexElement& element = layout.elements[e];
+				const VertexSemantic semantic = e < semantics.size() ? semantics[e] : VertexSemantic::Generic;
+				std::vector<Format> candidates = GetCandidates(semantic, element.size);
+				if (element.type != GL_FLOAT || element.size > 4)
+				{
+					candidates = { { element.type, element.normalized } }; // Already packed, kept as is
+				}
+
+				// Round trip every vertex through each candidate until one stays within budget
+				const float allowed = GetBudget(semantic, budget);
+				Format chosen = candidates.back();
+				float chosenError = 0.0f;
+				for (const Format& format : candidates)
+				{
+					if (format.type == element.type)
+					{
+						chosen = format;
+						chosenError = 0.0f;
+						break;
+					}
+					VertexElement trial = element;
+					trial.type = format.type;
+					trial.normalized = format.normalized;
+					trial.offset = 0;
+					float error = 0.0f;
+					for (size_t v = 0; v < vertexCount && error <= allowed; ++v)
+					{
+						float values[4] = {};
+						std::memcpy(values, source + v * layout.stride + element.offset, element.size * sizeof(float));
+						uint8_t packed[16] = {};
+						EncodeElement(format, element.size, values, packed);
+						const glm::vec4 decoded = Decode(trial, packed);
+						for (uint32_t i = 0; i < element.size; ++i)
+						{
+							error = std::max(error, std::abs(decoded[i] - values[i]));
+						}
+					}
+					if (error <= allowed)
+					{
+						chosen = format;
+						chosenError = error;
+						break;
+					}
+				}
+
+				VertexElement out = element;
+				out.type = chosen.type;
+				out.normalized = chosen.normalized;
+				if (chosen.type == GL_INT_2_10_10_10_REV)
+				{
+					out.size = 4; // The packed type only comes with four components
+				}
+				out.offset = offset;
+				offset = AlignUp(offset + GetElementSize(out));
+				encoded.layout.elements.push_back(out);
+				encoded.maxErrors.push_back(chosenError);
+				formats.push_back(chosen);
+			}
+			encoded.layout.stride = offset;
+
+			encoded.data.resize(vertexCount * encoded.layout.stride);
+			for (size_t v = 0; v < vertexCount; ++v)
+			{
+				const uint8_t* in = source + v * layout.stride;
+				uint8_t* out = encoded.data.data() + v * encoded.layout.stride;
+				for (size_t e = 0; e < layout.elements.size(); ++e)
+				{
+					const VertexElement& element = layout.elements[e];
+					const VertexElement& target = encoded.layout.elements[e];
+					if (element.type != GL_FLOAT || element.size > 4)
+					{
+						std::memcpy(out + target.offset, in + element.offset, GetElementSize(element));
+						continue;
+					}
+					float values[4] = {};
+					std::memcpy(values, in + element.offset, element.size * sizeof(float));
+					EncodeElement(formats[e], element.size, values, out + target.offset);
+				}
+			}
+			return encoded;
+		}
+
+		glm::vec4 Decode(const VertexElement& element, const uint8_t* vertex)
+		{
+			glm::vec4 value(0.0f, 0.0f, 0.0f, 1.0f);
+			const uint8_t* in = vertex + element.offset;
+			if (element.type == GL_INT_2_10_10_10_REV)
+			{
+				const uint32_t packed = Load<uint32_t>(in, 0);
+				for (uint32_t i = 0; i < 3; ++i)
+				{
+					const int32_t component = static_cast<int32_t>(packed << (22 - 10 * i)) >> 22; // Sign extended
+					value[i] = element.normalized ? std::max(component / 511.0f, -1.0f) : static_cast<float>(component);
+				}
+				const int32_t w = static_cast<int32_t>(packed) >> 30;
+				value.w = element.normalized ? std::max(static_cast<float>(w), -1.0f) : static_cast<float>(w);
+				return value;
+			}
+			if (!IsSupportedType(element.type))
+			{
+				return glm::vec4(0.0f);
+			}
+
+			for (uint32_t i = 0; i < std::min<uint32_t>(element.size, 4); ++i)
+			{
+				switch (element.type)
+				{
+				case GL_FLOAT: value[i] = Load<float>(in, i); break;
+				case GL_HALF_FLOAT: value[i] = HalfToFloat(Load<uint16_t>(in, i)); break;
+				case GL_UNSIGNED_BYTE:
+					value[i] = Load<uint8_t>(in, i) / (element.normalized ? 255.0f : 1.0f);
+					break;
+				case GL_BYTE:
+					value[i] = element.normalized ? std::max(Load<int8_t>(in, i) / 127.0f, -1.0f) : Load<int8_t>(in, i);
+					break;
+				case GL_UNSIGNED_SHORT:
+					value[i] = Load<uint16_t>(in, i) / (element.normalized ? 65535.0f : 1.0f);
+					break;
+				case GL_SHORT:
+					value[i] = element.normalized ? std::max(Load<int16_t>(in, i) / 32767.0f, -1.0f) : Load<int16_t>(in, i);
+					break;
+				}
+			}
+			return value;
+		}
+
+		bool IsSupportedType(GLenum type)
+		{
+			switch (type)
+			{
+			case GL_FLOAT:
+			case GL_HALF_FLOAT:
+			case GL_BYTE:
+			case GL_UNSIGNED_BYTE:
+			case GL_SHORT:
+			case GL_UNSIGNED_SHORT:
+			case GL_INT_2_10_10_10_REV:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		uint32_t GetElementSize(const VertexElement& element)
+		{
+			if (element.type == GL_INT_2_10_10_10_REV)
+			{
+				return 4;
+			}
+			return element.size * GetTypeSize(element.type);
+		}
+
+		uint16_t FloatToHalf(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			const uint32_t sign = bits & 0x80000000u;
+			bits ^= sign;
+
+			uint32_t half;
+			if (bits >= 0x47800000u) // 65536 and up: infinity, or NaN
+			{
+				half = bits > 0x7F800000u ? 0x7E00 : 0x7C00;
+			}
+			else if (bits < 0x38800000u) // Below the smallest normal half
+			{
+				// Adding 0.5 lines the 10 subnormal mantissa bits up at the bottom, the FPU rounds
+				const uint32_t magicBits = 0x3F000000u;
+				float magic;
+				float scaled;
+				std::memcpy(&magic, &magicBits, sizeof(magic));
+				std::memcpy(&scaled, &bits, sizeof(scaled));
+				scaled += magic;
+				std::memcpy(&half, &scaled, sizeof(half));
+				half -= magicBits;
+			}
+			else
+			{
+				const uint32_t mantissaOdd = (bits >> 13) & 1;
+				bits += 0xC8000FFFu; // Rebias the exponent from 127 to 15, round half up...
+				bits += mantissaOdd; // ...or to even on a tie
+				half = bits >> 13;
+			}
+			return static_cast<uint16_t>((sign >> 16) | half);
+		}
+
+		float HalfToFloat(uint16_t value)
+		{
+			const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+			const uint32_t exponent = (value >> 10) & 0x1F;
+			const uint32_t mantissa = value & 0x3FF;
+			if (exponent == 0)
+			{
+				const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+				return sign ? -magnitude : magnitude;
+			}
+
+			uint32_t bits = sign | (mantissa << 13);
+			bits |= exponent == 31 ? 0x7F800000u : (exponent + 112) << 23;
+			float result;
+			std::memcpy(&result, &bits, sizeof(result));
+			return result;
+		}
+	}
+}
\ No newline at end of file
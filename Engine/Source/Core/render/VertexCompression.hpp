@@ -0,0 +1,56 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+#include <glm/vec4.hpp>
+#include "Core/render/VertexLayout.hpp"
+
+namespace LEN
+{
+	// What an attribute holds, which decides the formats it may be stored in
+	enum class VertexSemantic : uint8_t
+	{
+		Generic, // Half or float
+		Position, // Half or float
+		Normal, // 10-10-10-2 or 16-bit signed normalized, unit vectors expected
+		Color, // 8 or 16-bit unsigned normalized, then half; values in [0, 1]
+		TexCoord, // 16-bit unsigned normalized for [0, 1], then half
+	};
+
+	// Largest error allowed per component, in the attribute's own units
+	struct VertexErrorBudget
+	{
+		float position = 1.0f / 1024.0f;
+		float normal = 1.0f / 256.0f;
+		float color = 0.5f / 255.0f;
+		float texCoord = 1.0f / 4096.0f;
+		float generic = 0.0f; // Only exact conversions
+	};
+
+	namespace VertexCompression
+	{
+		struct EncodedVertices
+		{
+			VertexLayout layout; // Same locations, smaller types; normalized set where needed
+			std::vector<uint8_t> data; // vertexCount * layout.stride bytes
+			std::vector<float> maxErrors; // Per element of layout, largest component error
+		};
+
+		// Converts vertices laid out by a float-only layout to the smallest format per element whose
+		// error stays within budget. semantics run parallel to layout.elements; missing entries are
+		// Generic. Elements are kept 4-byte aligned. Shaders need no change: GL converts normalized
+		// and half attributes back to float on fetch. Signed normalized values are encoded for the
+		// GL 4.2 rule (c / max), older contexts decode them within half a step of it.
+		EncodedVertices Encode(const VertexLayout& layout, const std::vector<float>& vertices,
+			const std::vector<VertexSemantic>& semantics, const VertexErrorBudget& budget = {});
+
+		// Reads one element of a vertex as float; missing components are 0, w is 1. Zero for
+		// unsupported types.
+		glm::vec4 Decode(const VertexElement& element, const uint8_t* vertex);
+		bool IsSupportedType(GLenum type);
+		uint32_t GetElementSize(const VertexElement& element); // Bytes
+
+		uint16_t FloatToHalf(float value); // Round to nearest even
+		float HalfToFloat(uint16_t value);
+	}
+}
\ No newline at end of file
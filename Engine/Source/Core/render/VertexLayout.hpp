@@ -11,12 +11,36 @@ namespace LEN
 		GLuint size;         // Number of components (e.g., 3 for vec3)
 		GLuint type;         // Data type (e.g., GL_FLOAT)
 		uint32_t offset;      // Bytes offset from the start of the vertex
+		GLuint divisor = 0;  // 0 = per vertex, n = advances once every n instances
+		bool normalized = false; // Integer types read as [0, 1] or [-1, 1], see VertexCompression
+
+		bool operator==(const VertexElement&) const = default;
 	};
 
+	// Standard per-instance input filled by RenderQueue: the model matrix as four vec4 columns.
+	// Shaders opt in to instancing by declaring
+	//     layout (location = 12) in mat4 aInstanceModel;
+	// and use it in place of the uModel uniform.
+	constexpr GLuint InstanceModelLocation = 12; // Takes locations 12..15
+	constexpr const char* InstanceModelAttribute = "aInstanceModel";
+
 	struct VertexLayout
 	{
 		std::vector<VertexElement> elements;
 		uint32_t stride = 0; // Total size of a single vertex in bytes
 
+		bool operator==(const VertexLayout&) const = default; // Meshes of equal layouts share a GeometryPool
+
+		// Layout of the instance buffer: one mat4 per instance at InstanceModelLocation
+		static VertexLayout InstanceTransform()
+		{
+			VertexLayout layout;
+			for (GLuint column = 0; column < 4; ++column)
+			{
+				layout.elements.push_back({ InstanceModelLocation + column, 4, GL_FLOAT, static_cast<uint32_t>(column * 4 * sizeof(float)), 1 });
+			}
+			layout.stride = 16 * sizeof(float);
+			return layout;
+		}
 	};
 }
\ No newline at end of file
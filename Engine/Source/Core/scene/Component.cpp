@@ -6,7 +6,7 @@
 
 namespace LEN {
 
-    size_t Component::nextId = 1;
+    std::atomic<size_t> Component::nextId{1};
 
     GameObject * Component::GetOwner() {
         return m_owner;
@@ -3,13 +3,15 @@
 //
 
 #pragma once
-
+#include <atomic>
+#include <cstddef>
 
 namespace LEN {
     class GameObject;
 
     class Component {
     public:
+        // May run on a job system thread, see the contract on Scene::SetParallelUpdate
         virtual void Update(float deltaTime) = 0;
 
         virtual ~Component() = default;
@@ -30,7 +32,7 @@ namespace LEN {
         friend class GameObject;
 
     private:
-        static size_t nextId;
+        static std::atomic<size_t> nextId; // Type ids may be first requested from several threads
     };
 
 #define COMPONENT(ComponentClass) \
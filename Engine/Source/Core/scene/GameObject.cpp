@@ -1,39 +1,72 @@
 #include "Core/scene/GameObject.hpp"
-
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/constants.hpp>
+#include "Core/scene/Scene.hpp"
+#include <cassert>
 
 namespace LEN
 {
+	namespace
+	{
+		Scene* ConstructingScene(Scene* scene)
+		{
+			assert(scene && "GameObjects must be created through Scene::CreateObject");
+			return scene;
+		}
+	}
+
+	GameObject::GameObject()
+		: m_scene(ConstructingScene(Scene::s_constructingScene)),
+		  m_pools(&m_scene->m_pools),
+		  m_name(m_pools->GetResource()),
+		  m_components(m_pools->GetResource())
+	{
+		m_transforms = &m_scene->m_transforms;
+		m_transformId = m_transforms->Create();
+		m_world = &m_scene->m_world;
+		m_entity = m_world->CreateEntity();
+	}
+
+	GameObject::~GameObject()
+	{
+		// Scene::Clear drops the store and the world wholesale
+		if (!m_scene->m_clearing)
+		{
+			ClearBounds();
+			m_world->DestroyEntity(m_entity);
+			m_transforms->Destroy(m_transformId);
+		}
+	}
+
 	void GameObject::Update(float deltaTime)
 	{
 		for (auto& component : m_components) {
 			component->Update(deltaTime);
 		}
 
-		for (auto it = m_children.begin(); it != m_children.end();)
+		// Dead children stay linked until the scene flushes destruction at the end of the frame
+		for (GameObject* child = m_firstChild; child; child = child->m_nextSibling)
 		{
-			if ((*it)->IsAlive())
-			{
-				(*it)->Update(deltaTime);
-				++it;
-			}
-			else
+			if (child->IsAlive())
 			{
-				it = m_children.erase(it);
+				child->Update(deltaTime);
 			}
 		}
 
 	}
 
-	const std::string& GameObject::GetName() const
+	std::string_view GameObject::GetName() const
 	{
 		return m_name;
 	}
 
-	void GameObject::SetName(const std::string& name)
+	void GameObject::SetName(std::string_view name)
 	{
 		m_name = name;
+		m_scene->IndexName(this, StringId(name));
+	}
+
+	StringId GameObject::GetNameId() const
+	{
+		return m_nameId;
 	}
 
 	GameObject* GameObject::GetParent()
@@ -41,6 +74,36 @@ namespace LEN
 		return m_parent;
 	}
 
+	Scene* GameObject::GetScene()
+	{
+		return m_scene;
+	}
+
+	ObjectHandle GameObject::GetHandle() const
+	{
+		return m_handle;
+	}
+
+	size_t GameObject::GetComponentCount() const
+	{
+		return m_components.size();
+	}
+
+	Component* GameObject::GetComponentAt(size_t index)
+	{
+		return m_components[index].get();
+	}
+
+	GameObject* GameObject::GetFirstChild()
+	{
+		return m_firstChild;
+	}
+
+	GameObject* GameObject::GetNextSibling()
+	{
+		return m_nextSibling;
+	}
+
 	bool GameObject::IsAlive() const
 	{
 		return m_isAlive;
@@ -48,73 +111,124 @@ namespace LEN
 
 	void GameObject::MarkForDestroy()
 	{
+		if (!m_isAlive)
+		{
+			return;
+		}
 		m_isAlive = false;
+		m_scene->QueueDestroy(m_handle);
 	}
 
 	void GameObject::AddComponent(Component *component) {
-		m_components.emplace_back(component);
+		AttachComponent(ComponentPtr(component));
+	}
+
+	void GameObject::AttachComponent(ComponentPtr component) {
 		component->m_owner = this;
+		m_world->Attach(m_entity, component.get()); // Makes it visible to World::View and GetComponent
+		m_components.push_back(std::move(component));
+	}
+
+	Entity GameObject::GetEntity() const
+	{
+		return m_entity;
 	}
 
 	// Transform accessors
-	const glm::vec3& GameObject::GetPosition() const
+	glm::vec3 GameObject::GetPosition() const
 	{
-		return m_position;
+		return m_transforms->GetPosition(m_transformId);
 	}
 
 	void GameObject::SetPosition(const glm::vec3& pos)
 	{
-		m_position = pos;
+		m_transforms->SetPosition(m_transformId, pos);
 	}
 
-	const glm::vec3& GameObject::GetRotation() const
+	glm::vec3 GameObject::GetRotation() const
 	{
-		return m_rotation;
+		return m_transforms->GetEulerRotation(m_transformId);
 	}
 
 	void GameObject::SetRotation(const glm::vec3& rot)
 	{
-		m_rotation = rot;
+		m_transforms->SetEulerRotation(m_transformId, rot);
 	}
 
-	const glm::vec3& GameObject::GetScale() const
+	glm::quat GameObject::GetRotationQuat() const
 	{
-		return m_scale;
+		return m_transforms->GetRotation(m_transformId);
+	}
+
+	void GameObject::SetRotation(const glm::quat& rot)
+	{
+		m_transforms->SetRotation(m_transformId, rot);
+	}
+
+	glm::vec3 GameObject::GetScale() const
+	{
+		return m_transforms->GetScale(m_transformId);
 	}
 
 	void GameObject::SetScale(const glm::vec3& scale)
 	{
-		m_scale = scale;
+		m_transforms->SetScale(m_transformId, scale);
 	}
 
-	// Compute local transformation matrix
 	glm::mat4 GameObject::GetLocalTransform() const
 	{
-		glm::mat4 mat = glm::mat4(1.0f); // Identity matrix
+		return m_transforms->GetLocalMatrix(m_transformId);
+	}
+
+	glm::mat4 GameObject::GetWorldTransform() const
+	{
+		return m_transforms->GetWorldMatrix(m_transformId);
+	}
+
+	glm::mat4 GameObject::GetInterpolatedWorldTransform(float alpha) const
+	{
+		return m_transforms->GetInterpolatedWorldMatrix(m_transformId, alpha);
+	}
+
+	glm::mat4 GameObject::GetCommittedWorldTransform() const
+	{
+		return m_transforms->GetCommittedWorldMatrix(m_transformId);
+	}
 
-		// Translation
-		mat = glm::translate(mat, m_position);
+	bool GameObject::IsTransformDirty() const
+	{
+		return m_transforms->IsWorldDirty(m_transformId);
+	}
 
-		// Rotation (assuming m_rotation is in radians)
-		mat = glm::rotate(mat, m_rotation.x, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate around X
-		mat = glm::rotate(mat, m_rotation.y, glm::vec3(0.0f, 1.0f, 0.0f)); // Rotate around Y
-		mat = glm::rotate(mat, m_rotation.z, glm::vec3(0.0f, 0.0f, 1.0f)); // Rotate around Z
+	TransformId GameObject::GetTransformId() const
+	{
+		return m_transformId;
+	}
 
-		// Scale
-		mat = glm::scale(mat, m_scale);
+	void GameObject::SetBounds(const AABB& localBounds)
+	{
+		m_localBounds = localBounds;
+		m_scene->UpdateProxy(this);
+	}
 
-		return mat;
+	void GameObject::ClearBounds()
+	{
+		m_scene->RemoveProxy(this);
 	}
 
-	// Compute world transformation matrix
-	glm::mat4 GameObject::GetWorldTransform() const
+	bool GameObject::HasBounds() const
 	{
-		if (m_parent)
-		{
-			return m_parent->GetWorldTransform() * GetLocalTransform();
-		}
-		// else не нужен — если выше был return, эта строка будет достигнута только когда if не выполнится
-		return GetLocalTransform();
+		return m_proxy != NullProxy;
+	}
+
+	const AABB& GameObject::GetLocalBounds() const
+	{
+		return m_localBounds;
+	}
+
+	AABB GameObject::GetWorldBounds() const
+	{
+		return AABB::Transform(m_localBounds, GetWorldTransform());
 	}
 
 
@@ -1,6 +1,13 @@
 #pragma once
 #include "Core/scene/Component.hpp"
+#include "Core/scene/TransformStore.hpp"
+#include "Core/scene/ObjectHandle.hpp"
+#include "Core/ecs/World.hpp"
+#include "Core/memory/SlabPool.hpp"
+#include "Core/strings/StringId.hpp"
+#include "Core/spatial/DynamicBVH.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <glm/vec3.hpp>
@@ -8,58 +15,109 @@
 
 namespace LEN
 {
+	class Scene;
+
 	class GameObject
 	{
 	public:
-		virtual ~GameObject() = default;
+		virtual ~GameObject();
 		virtual void Update(float deltaTime);
-		const std::string& GetName() const;
-		void SetName(const std::string& name); // Sets the name of the GameObject
+		std::string_view GetName() const;
+		void SetName(std::string_view name); // Sets the name of the GameObject, stored in the scene arena
+		StringId GetNameId() const; // Hashed name, key of Scene::FindObject
 		GameObject* GetParent(); // Get the parent GameObject, nullptr if root
+		Scene* GetScene(); // Scene that created and owns this object
+		ObjectHandle GetHandle() const; // Safe long-lived reference, see Scene::Resolve
 		bool IsAlive() const; // Check if the GameObject is alive
-		void MarkForDestroy(); // Mark the GameObject for destruction
+		void MarkForDestroy(); // Mark the GameObject and its subtree for destruction at the end of Scene::Update
+
+		// Children are an intrusive sibling list, iterate with GetFirstChild()->GetNextSibling()...
+		GameObject* GetFirstChild();
+		GameObject* GetNextSibling();
+
+		void AddComponent(Component* component); // Takes ownership of a heap allocated component
+		size_t GetComponentCount() const;
+		Component* GetComponentAt(size_t index); // In the order the components were added
 
-		void AddComponent(Component* component);
+		// Constructs the component in the scene's pool for T
+		template<typename T, typename... Args, typename = typename std::enable_if_t<std::is_base_of_v<Component, T>>>
+		T* AddComponent(Args&&... args) {
+			SlabPool& pool = m_pools->Get<T>();
+			T* component = new (pool.Allocate()) T(std::forward<Args>(args)...);
+			AttachComponent(ComponentPtr(component, PoolDeleter<Component>{ &pool }));
+			return component;
+		}
 		template<typename T, typename = typename std::enable_if_t<std::is_base_of_v<Component, T>>>
 		T* GetComponent() {
-			size_t typeId = Component::StaticTypeId<T>();
-
-			for (auto& component : m_components) {
-				if (component->GetTypeId() == typeId) {
-					return static_cast<T*>(component.get());
-				}
-			}
-			return nullptr;
+			// Components are attached to the object's entity, so this is a lookup instead of a scan
+			return m_world->Get<T>(m_entity);
 		}
+		Entity GetEntity() const; // Entity in the owning scene's World, carries the attached components
 
-		// Use glm::vec3 for positions/rotations/scales (float vectors)
-		const glm::vec3& GetPosition() const;
+		// Transform accessors are views into the owning scene's TransformStore
+		glm::vec3 GetPosition() const;
 		void SetPosition(const glm::vec3& pos);
 
-		const glm::vec3& GetRotation() const;
+		glm::vec3 GetRotation() const; // Euler angles in radians
 		void SetRotation(const glm::vec3& rot);
+		glm::quat GetRotationQuat() const;
+		void SetRotation(const glm::quat& rot);
 
-		const glm::vec3& GetScale() const;
+		glm::vec3 GetScale() const;
 		void SetScale(const glm::vec3& scale);
 
-		glm::mat4 GetLocalTransform() const;
-		glm::mat4 GetWorldTransform() const;
+		glm::mat4 GetLocalTransform() const; // Cached local matrix, recomputed on demand if dirty
+		glm::mat4 GetWorldTransform() const; // Cached world matrix, recomputed on demand if dirty
+		glm::mat4 GetInterpolatedWorldTransform(float alpha) const; // Between the last two transform updates, see TransformStore
+		// As of the last Scene::UpdateTransforms, i.e. the previous tick; the way to read other
+		// subtrees during the parallel update (see Scene)
+		glm::mat4 GetCommittedWorldTransform() const;
+		bool IsTransformDirty() const; // True until the next Scene::UpdateTransforms pass
+		TransformId GetTransformId() const;
+
+		// Local space bounds. Setting them registers the object in the scene's spatial index,
+		// which follows the object as Scene::UpdateTransforms moves it.
+		void SetBounds(const AABB& localBounds);
+		void ClearBounds();
+		bool HasBounds() const;
+		const AABB& GetLocalBounds() const;
+		AABB GetWorldBounds() const;
 
 
 	protected:
-		GameObject() = default;
+		GameObject(); // Only constructible inside Scene::CreateObject
 
 	private:
-		std::string m_name;
-		GameObject* m_parent = nullptr; // Pointer to parent GameObject, nullptr if root
-		std::vector<std::unique_ptr<GameObject>> m_children; // Owned child GameObjects
-		std::vector<std::unique_ptr<Component>> m_components; // Owned components
+		using ComponentPtr = std::unique_ptr<Component, PoolDeleter<Component>>;
+
+		void AttachComponent(ComponentPtr component);
+
+		Scene* m_scene = nullptr; // Initialized first, the members below allocate from its pools
+		ObjectPools* m_pools = nullptr;
+		std::pmr::string m_name;
+		StringId m_nameId;
+		uint32_t m_nameSlot = UINT32_MAX; // Position in the scene's name index bucket
+		ObjectHandle m_handle;
+		std::pmr::vector<ComponentPtr> m_components; // Owned components
 		bool m_isAlive = true; // Alive status
 
-		// Transform properties
-		glm::vec3 m_position = glm::vec3(0.0f);
-		glm::vec3 m_rotation = glm::vec3(0.0f);
-		glm::vec3 m_scale = glm::vec3(1.0f);
+		// Hierarchy links, owned by the scene registry. O(1) link/unlink on reparent and destroy.
+		GameObject* m_parent = nullptr; // Pointer to parent GameObject, nullptr if root
+		GameObject* m_firstChild = nullptr;
+		GameObject* m_lastChild = nullptr;
+		GameObject* m_prevSibling = nullptr;
+		GameObject* m_nextSibling = nullptr;
+		uint32_t m_rootIndex = UINT32_MAX; // Position in Scene::m_roots while this is a root
+
+		// Transform entry in the owning scene's store
+		TransformStore* m_transforms = nullptr;
+		TransformId m_transformId = InvalidTransformId;
+
+		World* m_world = nullptr;
+		Entity m_entity;
+
+		AABB m_localBounds;
+		ProxyId m_proxy = NullProxy; // Leaf in Scene::m_spatialIndex while the object has bounds
 
 
 		friend class Scene;
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+namespace LEN
+{
+	// Generational reference to a GameObject owned by a Scene.
+	// Resolving a handle whose object was destroyed yields nullptr instead of a dangling pointer.
+	struct ObjectHandle
+	{
+		uint32_t index = UINT32_MAX; // Slot in the scene registry
+		uint32_t generation = 0; // Bumped every time the slot is freed
+
+		bool IsNull() const { return index == UINT32_MAX; }
+		bool operator==(const ObjectHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+	};
+}
@@ -1,169 +1,482 @@
 #include "Scene.hpp"
+#include "Core/Engine.hpp"
 #include <algorithm>
 
 namespace LEN
 {
+	thread_local Scene* Scene::s_constructingScene = nullptr;
+	thread_local Scene::UpdateContext* Scene::s_updateContext = nullptr;
+
 	void Scene::Update(float deltaTime)
 	{
-		for (auto it = m_objects.begin(); it != m_objects.end();)
+		auto& jobSystem = Engine::GetInstance().GetJobSystem();
+		const size_t rootCount = m_roots.size();
+		const size_t chunkCount = (rootCount + m_rootsPerJob - 1) / m_rootsPerJob;
+
+		if (m_parallelUpdate && jobSystem.GetThreadCount() > 1 && chunkCount > 1)
+		{
+			m_updateContexts.resize(chunkCount);
+			jobSystem.ParallelFor(0, chunkCount, 1, [this, rootCount, deltaTime](size_t chunkBegin, size_t chunkEnd) {
+				// A thread waiting inside a nested job may run another chunk, so restore the outer context
+				UpdateContext* previous = s_updateContext;
+				for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+				{
+					s_updateContext = &m_updateContexts[chunk];
+					UpdateRoots(chunk * m_rootsPerJob, std::min(rootCount, (chunk + 1) * m_rootsPerJob), deltaTime);
+				}
+				s_updateContext = previous;
+			});
+		}
+		else
 		{
-			if ((*it)->IsAlive())
+			m_updateContexts.resize(1);
+			UpdateContext* previous = s_updateContext;
+			s_updateContext = &m_updateContexts[0];
+			UpdateRoots(0, rootCount, deltaTime);
+			s_updateContext = previous;
+		}
+
+		for (auto& context : m_updateContexts)
+		{
+			for (auto& command : context.deferred)
 			{
-				(*it)->Update(deltaTime);
-				++it;
+				command();
 			}
-			else
+			context.deferred.clear();
+		}
+
+		FlushDestroyed();
+		m_world.UpdateSystems(deltaTime);
+	}
+
+	void Scene::UpdateRoots(size_t begin, size_t end, float deltaTime)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (m_roots[i]->IsAlive())
+			{
+				m_roots[i]->Update(deltaTime);
+			}
+		}
+	}
+
+	void Scene::QueueDestroy(ObjectHandle handle)
+	{
+		if (s_updateContext)
+		{
+			s_updateContext->destroyed.push_back(handle);
+		}
+		else
+		{
+			m_pendingDestroy.push_back(handle);
+		}
+	}
+
+	void Scene::FlushDestroyed()
+	{
+		std::vector<ObjectHandle> destroyed;
+		for (auto& context : m_updateContexts)
+		{
+			destroyed.insert(destroyed.end(), context.destroyed.begin(), context.destroyed.end());
+			context.destroyed.clear();
+		}
+		destroyed.insert(destroyed.end(), m_pendingDestroy.begin(), m_pendingDestroy.end());
+		m_pendingDestroy.clear();
+
+		for (ObjectHandle handle : destroyed)
+		{
+			// Already gone when an ancestor was destroyed earlier in the batch
+			GameObject* obj = Resolve(handle);
+			if (obj)
 			{
-				it = m_objects.erase(it);
+				Unlink(obj);
+				DestroySubtree(obj);
 			}
 		}
 	}
 
+	void Scene::DestroySubtree(GameObject* obj)
+	{
+		// Children first so their transforms are leaves by the time they are removed
+		GameObject* child = obj->m_firstChild;
+		while (child)
+		{
+			GameObject* next = child->m_nextSibling;
+			DestroySubtree(child);
+			child = next;
+		}
+
+		if (m_mainCamera == obj)
+		{
+			m_mainCamera = nullptr;
+		}
+		UnindexName(obj);
+
+		Slot& slot = m_slots[obj->m_handle.index];
+		const uint32_t dense = slot.denseIndex;
+		++slot.generation;
+		slot.denseIndex = UINT32_MAX;
+		m_freeSlots.push_back(obj->m_handle.index);
+
+		// Swap-and-pop; the moved object's slot is pointed at its new place
+		if (dense != m_objects.size() - 1)
+		{
+			std::swap(m_objects[dense], m_objects.back());
+			m_slots[m_objects[dense]->m_handle.index].denseIndex = dense;
+		}
+		m_objects.pop_back();
+	}
+
+	void Scene::SetParallelUpdate(bool enabled, size_t rootsPerJob)
+	{
+		m_parallelUpdate = enabled;
+		m_rootsPerJob = std::max<size_t>(rootsPerJob, 1);
+	}
+
+	bool Scene::IsParallelUpdate() const
+	{
+		return m_parallelUpdate;
+	}
+
+	void Scene::Defer(std::function<void()> command)
+	{
+		if (s_updateContext)
+		{
+			s_updateContext->deferred.push_back(std::move(command));
+		}
+		else
+		{
+			command();
+		}
+	}
+
+	void Scene::UpdateTransforms()
+	{
+		m_updatedTransformCount = m_transforms.Update();
+
+		for (TransformId id : m_transforms.GetChangedIds())
+		{
+			if (id < m_boundedObjects.size() && m_boundedObjects[id])
+			{
+				UpdateProxy(m_boundedObjects[id]);
+			}
+		}
+	}
+
+	size_t Scene::GetUpdatedTransformCount() const
+	{
+		return m_updatedTransformCount;
+	}
+
+	Scene::~Scene()
+	{
+		Clear();
+	}
+
 	void Scene::Clear()
 	{
+		// Only the destructors run; every block goes back with its slab below
+		m_clearing = true;
+		for (auto& object : m_objects)
+		{
+			object.release()->~GameObject();
+		}
 		m_objects.clear();
+		m_clearing = false;
+
+		for (uint32_t index = 0; index < m_slots.size(); ++index)
+		{
+			if (m_slots[index].denseIndex != UINT32_MAX)
+			{
+				++m_slots[index].generation;
+				m_slots[index].denseIndex = UINT32_MAX;
+				m_freeSlots.push_back(index);
+			}
+		}
+		m_roots.clear();
+		m_pendingDestroy.clear();
+		m_nameIndex = decltype(m_nameIndex)(&m_nameIndexResource); // Drop the bucket array too before releasing its pool
+		m_nameIndexResource.release();
+		m_mainCamera = nullptr;
+
+		m_spatialIndex.Clear();
+		m_boundedObjects.clear();
+		m_world.Clear();
+		m_transforms.Clear();
+		m_pools.Release();
 	}
 
-	GameObject* Scene::CreateObject(const std::string& name, GameObject* parent)
+	GameObject* Scene::CreateObject(std::string_view name, GameObject* parent)
 	{
-		auto obj = new GameObject();
-		obj->SetName(name);
-		SetParent(obj, parent);
+		SlabPool& pool = m_pools.Get<GameObject>();
+		GameObject* obj = nullptr;
+		{
+			ConstructionScope scope(this);
+			obj = new (pool.Allocate()) GameObject(); // Protected constructor, Scene is a friend
+		}
+		AddObject(ObjectPtr(obj, PoolDeleter<GameObject>{ &pool }), name, parent);
 		return obj;
 	}
 
+	void Scene::AddObject(ObjectPtr object, std::string_view name, GameObject* parent)
+	{
+		uint32_t index = 0;
+		if (!m_freeSlots.empty())
+		{
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}
+
+		Slot& slot = m_slots[index];
+		slot.denseIndex = static_cast<uint32_t>(m_objects.size());
+
+		GameObject* raw = object.get();
+		raw->m_handle = ObjectHandle{ index, slot.generation };
+		raw->SetName(name);
+		m_objects.push_back(std::move(object));
+
+		Link(raw, parent);
+		if (parent)
+		{
+			m_transforms.SetParent(raw->m_transformId, parent->m_transformId);
+		}
+	}
+
 	bool Scene::SetParent(GameObject* obj, GameObject* parent)
 	{
-		bool result = false;
-		auto currentParent = obj->GetParent();
-		if (parent == nullptr)
+		if (obj == nullptr || obj == parent || obj->m_parent == parent)
+		{
+			return false;
+		}
+
+		// Refuse to make obj a descendant of itself
+		for (GameObject* current = parent; current; current = current->m_parent)
 		{
-			if (currentParent != nullptr)
+			if (current == obj)
 			{
-				auto it = std::find_if(
-					currentParent->m_children.begin(),
-					currentParent->m_children.end(),
-					[obj](const std::unique_ptr<GameObject>& elem)
-					{
-						return elem.get() == obj;
-					}
-				);
-
-				if (it != currentParent->m_children.end())
-				{
-					// Move the object from the current parent's children to the scene's root objects
-					m_objects.push_back(std::move(*it));
-					obj->m_parent = nullptr;
-					// Remove from current parent's children
-					currentParent->m_children.erase(it);
+				return false;
+			}
+		}
 
-					result = true;
-				}
+		Unlink(obj);
+		Link(obj, parent);
+
+		// New parent chain: the subtree picks up the change when the store propagates dirty flags
+		m_transforms.SetParent(obj->m_transformId, parent ? parent->m_transformId : InvalidTransformId);
+		return true;
+	}
+
+	void Scene::Link(GameObject* obj, GameObject* parent)
+	{
+		obj->m_parent = parent;
+		if (parent)
+		{
+			obj->m_prevSibling = parent->m_lastChild;
+			obj->m_nextSibling = nullptr;
+			if (parent->m_lastChild)
+			{
+				parent->m_lastChild->m_nextSibling = obj;
 			}
-			// No parent currently, nothing to do. This can be in 2 cases.
-			// 1. The object is in scene root already.
-			// 2. The object has been just created.
 			else
 			{
-				auto it = std::find_if(
-					m_objects.begin(),
-					m_objects.end(),
-					[obj](const std::unique_ptr<GameObject>& elem)
-					{
-						return elem.get() == obj;
-					}
-				);
-
-				if (it == m_objects.end())
-				{
-					std::unique_ptr<GameObject> objHolder(obj);
-					m_objects.push_back(std::move(objHolder));
-					result = true;
-				}
+				parent->m_firstChild = obj;
 			}
+			parent->m_lastChild = obj;
 		}
-		// We are trying to add it as a child of another object
 		else
 		{
-			if (currentParent != nullptr)
+			obj->m_rootIndex = static_cast<uint32_t>(m_roots.size());
+			m_roots.push_back(obj);
+		}
+	}
+
+	void Scene::Unlink(GameObject* obj)
+	{
+		if (GameObject* parent = obj->m_parent)
+		{
+			if (obj->m_prevSibling)
 			{
-				auto it = std::find_if(
-					currentParent->m_children.begin(),
-					currentParent->m_children.end(),
-					[obj](const std::unique_ptr<GameObject>& elem)
-					{
-						return elem.get() == obj;
-					}
-				);
-			
-				if (it != currentParent->m_children.end())
-				{
-					bool found = false;
-					auto currentElement = parent;
-					while (currentElement)
-					{
-						if (currentElement == obj)
-						{
-							found = true;
-							break;
-						}
-						currentElement = currentElement->GetParent();
-					}
-					if (!found)
-					{
-						parent->m_children.push_back(std::move(*it));
-						obj->m_parent = parent;
-						currentParent->m_children.erase(it);
-						result = true;
-					}
-				}
+				obj->m_prevSibling->m_nextSibling = obj->m_nextSibling;
 			}
-			// No parent currently, nothing to do. This can be in 2 cases.
-			// 1. The object is in scene root already.
-			// 2. The object has been just created.
 			else
 			{
-				auto it = std::find_if(
-					m_objects.begin(),
-					m_objects.end(),
-					[obj](const std::unique_ptr<GameObject>& elem)
-					{
-						return elem.get() == obj;
-					}
-				);
-
-				// The object has been just created
-				if (it == m_objects.end())
-				{
-					std::unique_ptr<GameObject> objHolder(obj);
-					parent->m_children.push_back(std::move(objHolder));
-					obj->m_parent = parent;
-					result = true;
-				}
-				else
-				{
-					bool found = false;
-					auto currentElement = parent;
-					while (currentElement)
-					{
-						if (currentElement == obj)
-						{
-							found = true;
-							break;
-						}
-						currentElement = currentElement->GetParent();
-					}
-
-					if (!found)
-						parent->m_children.push_back(std::move(*it));
-						obj->m_parent = parent;
-						m_objects.erase(it);
-						result = true;
-				}
+				parent->m_firstChild = obj->m_nextSibling;
+			}
+
+			if (obj->m_nextSibling)
+			{
+				obj->m_nextSibling->m_prevSibling = obj->m_prevSibling;
+			}
+			else
+			{
+				parent->m_lastChild = obj->m_prevSibling;
+			}
+			obj->m_prevSibling = nullptr;
+			obj->m_nextSibling = nullptr;
+		}
+		else if (obj->m_rootIndex != UINT32_MAX)
+		{
+			const uint32_t rootIndex = obj->m_rootIndex;
+			m_roots[rootIndex] = m_roots.back();
+			m_roots[rootIndex]->m_rootIndex = rootIndex;
+			m_roots.pop_back();
+		}
+		obj->m_parent = nullptr;
+		obj->m_rootIndex = UINT32_MAX;
+	}
+
+	GameObject* Scene::Resolve(ObjectHandle handle) const
+	{
+		if (handle.index >= m_slots.size())
+		{
+			return nullptr;
+		}
+
+		const Slot& slot = m_slots[handle.index];
+		if (slot.generation != handle.generation || slot.denseIndex == UINT32_MAX)
+		{
+			return nullptr;
+		}
+		return m_objects[slot.denseIndex].get();
+	}
+
+	size_t Scene::GetObjectCount() const
+	{
+		return m_objects.size();
+	}
+
+	void Scene::Reserve(size_t objectCount)
+	{
+		m_slots.reserve(objectCount);
+		m_objects.reserve(objectCount);
+		m_transforms.Reserve(objectCount);
+		m_world.Reserve(objectCount);
+
+		std::lock_guard<std::mutex> lock(m_nameIndexMutex);
+		m_nameIndex.reserve(objectCount);
+	}
+
+	size_t Scene::GetRootCount() const
+	{
+		return m_roots.size();
+	}
+
+	GameObject* Scene::GetRoot(size_t index)
+	{
+		return m_roots[index];
+	}
+
+	GameObject* Scene::FindObject(StringId name) const
+	{
+		std::lock_guard<std::mutex> lock(m_nameIndexMutex);
+		auto it = m_nameIndex.find(name);
+		return it != m_nameIndex.end() && !it->second.empty() ? it->second.front() : nullptr;
+	}
+
+	GameObject* Scene::FindObject(std::string_view name) const
+	{
+		return FindObject(StringId(name));
+	}
+
+	size_t Scene::FindObjects(StringId name, std::vector<GameObject*>& out) const
+	{
+		std::lock_guard<std::mutex> lock(m_nameIndexMutex);
+		auto it = m_nameIndex.find(name);
+		if (it == m_nameIndex.end())
+		{
+			return 0;
+		}
+		out.insert(out.end(), it->second.begin(), it->second.end());
+		return it->second.size();
+	}
+
+	void Scene::IndexName(GameObject* obj, StringId name)
+	{
+		std::lock_guard<std::mutex> lock(m_nameIndexMutex);
+		if (obj->m_nameSlot != UINT32_MAX && obj->m_nameId == name)
+		{
+			return;
+		}
+		RemoveNameSlot(obj);
+
+		auto& bucket = m_nameIndex[name];
+		obj->m_nameId = name;
+		obj->m_nameSlot = static_cast<uint32_t>(bucket.size());
+		bucket.push_back(obj);
+	}
+
+	void Scene::UnindexName(GameObject* obj)
+	{
+		std::lock_guard<std::mutex> lock(m_nameIndexMutex);
+		RemoveNameSlot(obj);
+	}
+
+	void Scene::RemoveNameSlot(GameObject* obj)
+	{
+		if (obj->m_nameSlot == UINT32_MAX)
+		{
+			return;
+		}
+
+		auto& bucket = m_nameIndex[obj->m_nameId];
+		bucket[obj->m_nameSlot] = bucket.back();
+		bucket[obj->m_nameSlot]->m_nameSlot = obj->m_nameSlot;
+		bucket.pop_back();
+		obj->m_nameSlot = UINT32_MAX;
+	}
+
+	void Scene::UpdateProxy(GameObject* obj)
+	{
+		const AABB bounds = obj->GetWorldBounds();
+		if (obj->m_proxy == NullProxy)
+		{
+			obj->m_proxy = m_spatialIndex.CreateProxy(bounds, obj);
+			if (obj->m_transformId >= m_boundedObjects.size())
+			{
+				m_boundedObjects.resize(obj->m_transformId + 1, nullptr);
 			}
+			m_boundedObjects[obj->m_transformId] = obj;
+			return;
 		}
 
-		return result;
+		// Stretch the fat bounds along the motion so steady movement reinserts less often
+		const glm::vec3 displacement = bounds.GetCenter() - m_spatialIndex.GetBounds(obj->m_proxy).GetCenter();
+		m_spatialIndex.MoveProxy(obj->m_proxy, bounds, displacement);
+	}
+
+	void Scene::RemoveProxy(GameObject* obj)
+	{
+		if (obj->m_proxy == NullProxy)
+		{
+			return;
+		}
+		m_spatialIndex.DestroyProxy(obj->m_proxy);
+		m_boundedObjects[obj->m_transformId] = nullptr;
+		obj->m_proxy = NullProxy;
+	}
+
+	const DynamicBVH& Scene::GetSpatialIndex() const
+	{
+		return m_spatialIndex;
+	}
+
+	GameObject* Scene::Raycast(const Ray& ray, float* distance) const
+	{
+		RayHit hit;
+		if (!m_spatialIndex.RaycastClosest(ray, hit))
+		{
+			return nullptr;
+		}
+		if (distance)
+		{
+			*distance = hit.distance;
+		}
+		return static_cast<GameObject*>(m_spatialIndex.GetUserData(hit.proxy));
 	}
 
 	void Scene::SetMainCamera(GameObject *camera) {
@@ -174,4 +487,24 @@ namespace LEN
 		return  m_mainCamera;
 	}
 
+	TransformStore& Scene::GetTransforms()
+	{
+		return m_transforms;
+	}
+
+	World& Scene::GetWorld()
+	{
+		return m_world;
+	}
+
+	ObjectPools& Scene::GetPools()
+	{
+		return m_pools;
+	}
+
+	std::pmr::memory_resource* Scene::GetMemoryResource()
+	{
+		return m_pools.GetResource();
+	}
+
 }
@@ -1,8 +1,19 @@
 #pragma once
 #include "Core/scene/GameObject.hpp"
+#include "Core/scene/TransformStore.hpp"
+#include "Core/scene/ObjectHandle.hpp"
+#include "Core/ecs/World.hpp"
+#include "Core/memory/SlabPool.hpp"
+#include "Core/strings/StringId.hpp"
+#include "Core/spatial/DynamicBVH.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <mutex>
+#include <memory_resource>
+#include <unordered_map>
 #include <type_traits>
 
 
@@ -13,37 +24,160 @@ namespace LEN
 	class Scene
 	{
 	public:
+		Scene() = default;
+		Scene(const Scene&) = delete;
+		Scene& operator=(const Scene&) = delete;
+		~Scene();
+
 		void Update(float deltaTime);
+		// Runs the object destructors but skips the per-object bookkeeping: transforms, entities,
+		// names and component storage are released together in O(slabs)
 		void Clear();
 
-		GameObject* CreateObject(const std::string& name, GameObject* parent = nullptr);
+		/************************************************************************
+		 *                      PARALLEL UPDATE CONTRACT                          *
+		 *  Root objects are split into chunks of rootsPerJob and updated on     *
+		 *  job system threads. While a root subtree is being updated, its       *
+		 *  components and objects may:                                          *
+		 *   - read and write anything inside their own root subtree             *
+		 *   - read other subtrees' transforms through                           *
+		 *     GetCommittedWorldTransform only: the world matrix of the last     *
+		 *     UpdateTransforms pass, so the previous tick's value whatever the  *
+		 *     thread count. Anything else of another subtree (local TRS,        *
+		 *     GetWorldTransform, IsTransformDirty, components) is written by    *
+		 *     its own update meanwhile; read it in a Defer() command.           *
+		 *   - resolve handles and find objects by name                          *
+		 *   - submit to the engine RenderQueue (recorded per thread)            *
+		 *  Everything else (CreateObject, SetParent, SetMainCamera, writes to   *
+		 *  other subtrees, MarkForDestroy of other objects, AddComponent and    *
+		 *  any other World change, SetBounds/ClearBounds) must go through       *
+		 *  Defer(). Spatial index queries are read-only and safe. Deferred      *
+		 *  commands run on the calling thread after all roots have been         *
+		 *  updated, in root order, so the result does not depend on the thread  *
+		 *  count.                                                               *
+		 *  MarkForDestroy of the own subtree is safe: objects are only unlinked *
+		 *  and freed when the frame's destroys are flushed.                     *
+		 ************************************************************************/
+		void SetParallelUpdate(bool enabled, size_t rootsPerJob = 64);
+		bool IsParallelUpdate() const;
+
+		// Queue a structural change until the end of the current Update; runs immediately outside Update
+		void Defer(std::function<void()> command);
+
+		// Recompute dirty local/world matrices top-down and move the spatial index proxies of the
+		// objects that changed. Called by the engine once per frame.
+		void UpdateTransforms();
+		size_t GetUpdatedTransformCount() const; // Transforms recomputed by the last UpdateTransforms pass
+
+		GameObject* CreateObject(std::string_view name, GameObject* parent = nullptr);
 
 		template<typename T, typename = typename std::enable_if_t<std::is_base_of_v<GameObject, T>>>
-		T* CreateObject(const std::string& name, GameObject* parent = nullptr)
+		T* CreateObject(std::string_view name, GameObject* parent = nullptr)
 		{
-			auto obj = std::make_unique<T>();
-			obj->SetName(name);
-			GameObject* raw = obj.get();
-			if (parent)
-			{
-				parent->m_children.push_back(std::move(obj));
-				raw->m_parent = parent;
-			}
-			else
+			SlabPool& pool = m_pools.Get<T>();
+			T* obj = nullptr;
 			{
-				m_objects.push_back(std::move(obj));
-				raw->m_parent = nullptr;
+				ConstructionScope scope(this);
+				obj = new (pool.Allocate()) T();
 			}
-			return static_cast<T*>(raw);
+			AddObject(ObjectPtr(obj, PoolDeleter<GameObject>{ &pool }), name, parent);
+			return obj;
 		}
 
+		// Reparents in O(1) (plus the cycle check walking up from parent). nullptr moves obj to the roots.
 		bool SetParent(GameObject* obj, GameObject* parent);
 
+		// Returns nullptr when the handle is null or its object has been destroyed
+		GameObject* Resolve(ObjectHandle handle) const;
+		size_t GetObjectCount() const;
+		void Reserve(size_t objectCount); // Capacity for objectCount objects in total, used by bulk loads
+
+		// Root objects in update order; the order changes when roots are reparented or destroyed
+		size_t GetRootCount() const;
+		GameObject* GetRoot(size_t index);
+
+		// O(1) lookup through the scene's name index. With several objects of the same name
+		// FindObject returns any one of them; FindObjects appends all of them to out.
+		GameObject* FindObject(StringId name) const;
+		GameObject* FindObject(std::string_view name) const;
+		size_t FindObjects(StringId name, std::vector<GameObject*>& out) const;
+
 		void SetMainCamera(GameObject* camera);
 		GameObject* GetMainCamera();
 
+		TransformStore& GetTransforms();
+		ObjectPools& GetPools(); // Per-type slabs for objects and components
+		std::pmr::memory_resource* GetMemoryResource(); // Scene arena, released by Clear
+
+		// Objects with bounds (GameObject::SetBounds); proxy user data is the GameObject*
+		const DynamicBVH& GetSpatialIndex() const;
+		GameObject* Raycast(const Ray& ray, float* distance = nullptr) const; // Closest object hit by the ray
+		World& GetWorld(); // Entities of all objects plus pure ECS entities; systems run at the end of Update
+
 	private:
-		std::vector<std::unique_ptr<GameObject>> m_objects;
+		// Lets GameObject's constructor find the store of the scene creating it
+		struct ConstructionScope
+		{
+			explicit ConstructionScope(Scene* scene) : previous(s_constructingScene) { s_constructingScene = scene; }
+			~ConstructionScope() { s_constructingScene = previous; }
+			Scene* previous;
+		};
+		static thread_local Scene* s_constructingScene;
+
+		// Work recorded while updating one chunk of roots, applied serially afterwards
+		struct UpdateContext
+		{
+			std::vector<std::function<void()>> deferred;
+			std::vector<ObjectHandle> destroyed; // Objects marked for destroy, freed after the update
+		};
+		static thread_local UpdateContext* s_updateContext;
+
+		// Registry slot; the generation is bumped on free so old handles stop resolving
+		struct Slot
+		{
+			uint32_t generation = 0;
+			uint32_t denseIndex = UINT32_MAX; // Index into m_objects, UINT32_MAX while free
+		};
+
+		using ObjectPtr = std::unique_ptr<GameObject, PoolDeleter<GameObject>>;
+
+		void AddObject(ObjectPtr object, std::string_view name, GameObject* parent);
+		void Link(GameObject* obj, GameObject* parent);
+		void Unlink(GameObject* obj);
+		void QueueDestroy(ObjectHandle handle);
+		void FlushDestroyed();
+		void DestroySubtree(GameObject* obj);
+		void IndexName(GameObject* obj, StringId name); // Moves obj to the bucket of its new name
+		void UnindexName(GameObject* obj);
+		void RemoveNameSlot(GameObject* obj); // Caller holds m_nameIndexMutex
+		void UpdateProxy(GameObject* obj);
+		void RemoveProxy(GameObject* obj);
+		void UpdateRoots(size_t begin, size_t end, float deltaTime);
+
+		// Declared before the objects so they outlive them
+		ObjectPools m_pools;
+		TransformStore m_transforms;
+		World m_world;
+		DynamicBVH m_spatialIndex;
+		std::vector<GameObject*> m_boundedObjects; // Indexed by TransformId, nullptr without bounds
+		std::vector<Slot> m_slots;
+		std::vector<uint32_t> m_freeSlots;
+		std::vector<ObjectPtr> m_objects; // Densely packed, order is not meaningful
+		std::vector<GameObject*> m_roots; // Update order
+		std::vector<ObjectHandle> m_pendingDestroy; // Marked outside of Update
+		// Nodes and buckets come from their own pool so indexing a name is not a heap allocation.
+		// Both are guarded by m_nameIndexMutex.
+		std::pmr::unsynchronized_pool_resource m_nameIndexResource;
+		std::pmr::unordered_map<StringId, std::pmr::vector<GameObject*>> m_nameIndex{ &m_nameIndexResource }; // Swap-and-pop buckets
+		mutable std::mutex m_nameIndexMutex; // Objects may rename themselves during a parallel update
 		GameObject* m_mainCamera = nullptr;
+		size_t m_updatedTransformCount = 0;
+		bool m_clearing = false;
+
+		bool m_parallelUpdate = false;
+		size_t m_rootsPerJob = 64;
+		std::vector<UpdateContext> m_updateContexts;
+
+		friend class GameObject;
 	};
 }
\ No newline at end of file
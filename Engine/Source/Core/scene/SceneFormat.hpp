@@ -0,0 +1,86 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+// On-disk layout of binary scenes (.lens). Every section is an array of fixed size records at an
+// 8-byte aligned offset from the start of the file, so a mapped file is used in place: the loader
+// casts the sections instead of parsing them. All offsets are relative to the file start, which
+// keeps the mapping read-only and shareable. Little-endian only.
+namespace LEN::SceneFormat
+{
+	static_assert(std::endian::native == std::endian::little, "Binary scenes are stored little-endian");
+
+	constexpr uint32_t Magic = 0x534E454C; // "LENS"
+	constexpr uint32_t Version = 1; // Bump on any layout change, old files are rejected
+	constexpr uint32_t NoIndex = UINT32_MAX;
+
+	struct Section
+	{
+		uint64_t offset = 0; // Bytes from the start of the file
+		uint64_t count = 0; // Records, or bytes for the blob sections
+	};
+
+	struct Header
+	{
+		uint32_t magic = Magic;
+		uint32_t version = Version;
+		uint32_t mainCamera = NoIndex; // Object index
+		uint32_t reserved = 0;
+		Section objects; // Object[]
+		Section transforms; // Transform[], parallel to objects
+		Section components; // Component[], grouped by object
+		Section assets; // Asset[], every asset referenced by component data
+		Section componentData; // Bytes
+		Section strings; // Bytes, not null terminated
+	};
+
+	// Objects are stored in hierarchy pre-order: a parent always precedes its children
+	struct Object
+	{
+		uint32_t parent = NoIndex; // Object index
+		uint32_t nameOffset = 0; // Into the string section
+		uint32_t nameLength = 0;
+		uint32_t firstComponent = 0;
+		uint32_t componentCount = 0;
+		uint32_t reserved = 0;
+	};
+
+	struct Transform
+	{
+		float position[3];
+		float rotation[4]; // Quaternion x, y, z, w
+		float scale[3];
+	};
+
+	struct Component
+	{
+		uint64_t type = 0; // StringId hash of the name given to SceneSerializer::RegisterComponent
+		uint32_t dataOffset = 0; // Into the component data section
+		uint32_t dataSize = 0;
+	};
+
+	enum class AssetType : uint32_t
+	{
+		Mesh,
+		Material,
+	};
+
+	// Lets tools list the dependencies of a scene; component data refers to assets by name hash
+	struct Asset
+	{
+		uint64_t name = 0; // StringId hash
+		AssetType type = AssetType::Mesh;
+		uint32_t nameOffset = 0; // Into the string section
+		uint32_t nameLength = 0;
+		uint32_t reserved = 0;
+	};
+
+	constexpr uint64_t SectionAlignment = 8;
+
+	static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 112);
+	static_assert(std::is_trivially_copyable_v<Object> && sizeof(Object) == 24);
+	static_assert(std::is_trivially_copyable_v<Transform> && sizeof(Transform) == 40);
+	static_assert(std::is_trivially_copyable_v<Component> && sizeof(Component) == 16);
+	static_assert(std::is_trivially_copyable_v<Asset> && sizeof(Asset) == 24);
+}
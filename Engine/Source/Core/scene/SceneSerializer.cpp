@@ -0,0 +1,459 @@
+#include "Core/scene/SceneSerializer.hpp"
+#include "Core/scene/Scene.hpp"
+#include "Core/scene/GameObject.hpp"
+#include "Core/scene/components/CameraComponent.hpp"
+#include "Core/scene/components/MeshComponent.hpp"
+#include "Core/io/MappedFile.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+namespace LEN
+{
+	namespace
+	{
+		uint64_t Align(uint64_t offset)
+		{
+			return (offset + SceneFormat::SectionAlignment - 1) & ~(SceneFormat::SectionAlignment - 1);
+		}
+
+		bool IsSectionValid(const SceneFormat::Section& section, size_t recordSize, size_t fileSize)
+		{
+			return section.offset % SceneFormat::SectionAlignment == 0
+				&& section.offset <= fileSize
+				&& section.count <= (fileSize - section.offset) / recordSize;
+		}
+
+		bool IsRangeValid(uint64_t offset, uint64_t size, uint64_t sectionSize)
+		{
+			return offset <= sectionSize && size <= sectionSize - offset;
+		}
+
+		template<typename T>
+		const T* SectionData(const uint8_t* file, const SceneFormat::Section& section)
+		{
+			return reinterpret_cast<const T*>(file + section.offset); // Aligned: page aligned base, 8-aligned offset
+		}
+	}
+
+	void SceneAssets::AddMesh(std::string_view name, std::shared_ptr<Mesh> mesh)
+	{
+		Add(name, SceneFormat::AssetType::Mesh, std::move(mesh));
+	}
+
+	void SceneAssets::AddMaterial(std::string_view name, std::shared_ptr<Material> material)
+	{
+		Add(name, SceneFormat::AssetType::Material, std::move(material));
+	}
+
+	std::shared_ptr<Mesh> SceneAssets::FindMesh(StringId name) const
+	{
+		return std::static_pointer_cast<Mesh>(Find(name, SceneFormat::AssetType::Mesh));
+	}
+
+	std::shared_ptr<Material> SceneAssets::FindMaterial(StringId name) const
+	{
+		return std::static_pointer_cast<Material>(Find(name, SceneFormat::AssetType::Material));
+	}
+
+	StringId SceneAssets::GetName(const void* asset) const
+	{
+		auto it = m_names.find(asset);
+		return it != m_names.end() ? it->second : StringId();
+	}
+
+	std::string_view SceneAssets::GetNameString(StringId name) const
+	{
+		auto it = m_assets.find(name);
+		return it != m_assets.end() ? std::string_view(it->second.name) : std::string_view();
+	}
+
+	void SceneAssets::Add(std::string_view name, SceneFormat::AssetType type, std::shared_ptr<void> asset)
+	{
+		const StringId id(name);
+		auto it = m_assets.find(id);
+		if (it != m_assets.end())
+		{
+			m_names.erase(it->second.asset.get());
+		}
+		m_names[asset.get()] = id;
+		m_assets[id] = Entry{ std::string(name), type, std::move(asset) };
+	}
+
+	std::shared_ptr<void> SceneAssets::Find(StringId name, SceneFormat::AssetType type) const
+	{
+		auto it = m_assets.find(name);
+		return it != m_assets.end() && it->second.type == type ? it->second.asset : nullptr;
+	}
+
+	ComponentWriter::ComponentWriter(std::vector<uint8_t>& data, const SceneAssets& assets)
+		: m_data(data), m_assets(assets)
+	{
+	}
+
+	void ComponentWriter::WriteAsset(const Mesh* mesh)
+	{
+		WriteAsset(mesh, SceneFormat::AssetType::Mesh);
+	}
+
+	void ComponentWriter::WriteAsset(const Material* material)
+	{
+		WriteAsset(material, SceneFormat::AssetType::Material);
+	}
+
+	void ComponentWriter::WriteAsset(const void* asset, SceneFormat::AssetType type)
+	{
+		const StringId name = asset ? m_assets.GetName(asset) : StringId();
+		if (asset && name.IsEmpty())
+		{
+			std::cerr << "SceneSerializer: component references an asset missing from SceneAssets, saved as null" << std::endl;
+		}
+		if (!name.IsEmpty())
+		{
+			m_referencedAssets.emplace_back(name, type);
+		}
+		Write(name.GetHash());
+	}
+
+	const std::vector<std::pair<StringId, SceneFormat::AssetType>>& ComponentWriter::GetReferencedAssets() const
+	{
+		return m_referencedAssets;
+	}
+
+	ComponentReader::ComponentReader(const uint8_t* data, size_t size, const SceneAssets& assets)
+		: m_data(data), m_size(size), m_assets(assets)
+	{
+	}
+
+	std::shared_ptr<Mesh> ComponentReader::ReadMesh()
+	{
+		return m_assets.FindMesh(StringId::FromHash(Read<uint64_t>()));
+	}
+
+	std::shared_ptr<Material> ComponentReader::ReadMaterial()
+	{
+		return m_assets.FindMaterial(StringId::FromHash(Read<uint64_t>()));
+	}
+
+	bool ComponentReader::IsValid() const
+	{
+		return !m_overrun;
+	}
+
+	SceneSerializer::SceneSerializer()
+	{
+		RegisterComponent<CameraComponent>("CameraComponent",
+			[](const CameraComponent& camera, ComponentWriter& writer) {
+				writer.Write(camera.GetFov());
+				writer.Write(camera.GetNearPlane());
+				writer.Write(camera.GetFarPlane());
+			},
+			[](GameObject& object, ComponentReader& reader) {
+				auto* camera = object.AddComponent<CameraComponent>();
+				camera->SetFov(reader.Read<float>());
+				camera->SetNearPlane(reader.Read<float>());
+				camera->SetFarPlane(reader.Read<float>());
+				return reader.IsValid();
+			});
+
+		RegisterComponent<MeshComponent>("MeshComponent",
+			[](const MeshComponent& mesh, ComponentWriter& writer) {
+				writer.WriteAsset(mesh.GetMaterial().get());
+				writer.WriteAsset(mesh.GetMesh().get());
+			},
+			[](GameObject& object, ComponentReader& reader) {
+				auto material = reader.ReadMaterial();
+				auto mesh = reader.ReadMesh();
+				object.AddComponent<MeshComponent>(material, mesh);
+				return reader.IsValid();
+			});
+	}
+
+	SceneAssets& SceneSerializer::GetAssets()
+	{
+		return m_assets;
+	}
+
+	const SceneAssets& SceneSerializer::GetAssets() const
+	{
+		return m_assets;
+	}
+
+	bool SceneSerializer::Save(Scene& scene, const std::string& path) const
+	{
+		std::vector<SceneFormat::Object> objects;
+		std::vector<SceneFormat::Transform> transforms;
+		std::vector<SceneFormat::Component> components;
+		std::vector<SceneFormat::Asset> assets;
+		std::vector<uint8_t> componentData;
+		std::vector<char> strings;
+
+		objects.reserve(scene.GetObjectCount());
+		transforms.reserve(scene.GetObjectCount());
+
+		SceneFormat::Header header;
+		std::unordered_set<size_t> unsupportedTypes;
+		std::unordered_set<StringId> writtenAssets;
+
+		auto appendString = [&strings](std::string_view text, uint32_t& offset, uint32_t& length) {
+			offset = static_cast<uint32_t>(strings.size());
+			length = static_cast<uint32_t>(text.size());
+			strings.insert(strings.end(), text.begin(), text.end());
+		};
+
+		// Pre-order walk so every parent is written before its children
+		struct Pending
+		{
+			GameObject* object;
+			uint32_t parent;
+		};
+		std::vector<Pending> stack;
+		std::vector<GameObject*> children;
+		for (size_t i = scene.GetRootCount(); i-- > 0;)
+		{
+			stack.push_back({ scene.GetRoot(i), SceneFormat::NoIndex });
+		}
+
+		while (!stack.empty())
+		{
+			const Pending pending = stack.back();
+			stack.pop_back();
+			GameObject* object = pending.object;
+			if (!object->IsAlive())
+			{
+				continue; // Marked for destroy, its subtree goes with it
+			}
+
+			const uint32_t index = static_cast<uint32_t>(objects.size());
+			if (object == scene.GetMainCamera())
+			{
+				header.mainCamera = index;
+			}
+
+			SceneFormat::Object record;
+			record.parent = pending.parent;
+			appendString(object->GetName(), record.nameOffset, record.nameLength);
+			record.firstComponent = static_cast<uint32_t>(components.size());
+
+			for (size_t c = 0; c < object->GetComponentCount(); ++c)
+			{
+				Component* component = object->GetComponentAt(c);
+				auto saver = m_savers.find(component->GetTypeId());
+				if (saver == m_savers.end())
+				{
+					if (unsupportedTypes.insert(component->GetTypeId()).second)
+					{
+						std::cerr << "SceneSerializer: component type " << component->GetTypeId() << " has no registered codec, not saved" << std::endl;
+					}
+					continue;
+				}
+
+				// Blobs start 8-aligned so codecs may store wide values without straddling
+				componentData.resize(Align(componentData.size()));
+				SceneFormat::Component componentRecord;
+				componentRecord.type = saver->second.type.GetHash();
+				componentRecord.dataOffset = static_cast<uint32_t>(componentData.size());
+
+				ComponentWriter writer(componentData, m_assets);
+				saver->second.save(*component, writer);
+				componentRecord.dataSize = static_cast<uint32_t>(componentData.size() - componentRecord.dataOffset);
+				components.push_back(componentRecord);
+
+				for (auto& [name, type] : writer.GetReferencedAssets())
+				{
+					if (writtenAssets.insert(name).second)
+					{
+						SceneFormat::Asset asset;
+						asset.name = name.GetHash();
+						asset.type = type;
+						appendString(m_assets.GetNameString(name), asset.nameOffset, asset.nameLength);
+						assets.push_back(asset);
+					}
+				}
+			}
+			record.componentCount = static_cast<uint32_t>(components.size()) - record.firstComponent;
+			objects.push_back(record);
+
+			SceneFormat::Transform transform;
+			const glm::vec3 position = object->GetPosition();
+			const glm::quat rotation = object->GetRotationQuat();
+			const glm::vec3 scale = object->GetScale();
+			transform.position[0] = position.x; transform.position[1] = position.y; transform.position[2] = position.z;
+			transform.rotation[0] = rotation.x; transform.rotation[1] = rotation.y; transform.rotation[2] = rotation.z; transform.rotation[3] = rotation.w;
+			transform.scale[0] = scale.x; transform.scale[1] = scale.y; transform.scale[2] = scale.z;
+			transforms.push_back(transform);
+
+			children.clear();
+			for (GameObject* child = object->GetFirstChild(); child; child = child->GetNextSibling())
+			{
+				children.push_back(child);
+			}
+			for (size_t i = children.size(); i-- > 0;)
+			{
+				stack.push_back({ children[i], index });
+			}
+		}
+
+		// Lay the sections out back to back after the header
+		uint64_t offset = Align(sizeof(SceneFormat::Header));
+		auto place = [&offset](SceneFormat::Section& section, uint64_t count, uint64_t recordSize) {
+			section.offset = offset;
+			section.count = count;
+			offset = Align(offset + count * recordSize);
+		};
+		place(header.objects, objects.size(), sizeof(SceneFormat::Object));
+		place(header.transforms, transforms.size(), sizeof(SceneFormat::Transform));
+		place(header.components, components.size(), sizeof(SceneFormat::Component));
+		place(header.assets, assets.size(), sizeof(SceneFormat::Asset));
+		place(header.componentData, componentData.size(), 1);
+		place(header.strings, strings.size(), 1);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "SceneSerializer: cannot write " << path << std::endl;
+			return false;
+		}
+
+		auto write = [&file](const void* data, uint64_t size) {
+			file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+			static const char padding[SceneFormat::SectionAlignment] = {};
+			file.write(padding, static_cast<std::streamsize>(Align(size) - size));
+		};
+		write(&header, sizeof(header));
+		write(objects.data(), objects.size() * sizeof(SceneFormat::Object));
+		write(transforms.data(), transforms.size() * sizeof(SceneFormat::Transform));
+		write(components.data(), components.size() * sizeof(SceneFormat::Component));
+		write(assets.data(), assets.size() * sizeof(SceneFormat::Asset));
+		write(componentData.data(), componentData.size());
+		write(strings.data(), strings.size());
+
+		if (!file)
+		{
+			std::cerr << "SceneSerializer: failed writing " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool SceneSerializer::Load(Scene& scene, const std::string& path) const
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			return false;
+		}
+
+		const uint8_t* data = file.GetData();
+		const size_t size = file.GetSize();
+		if (size < sizeof(SceneFormat::Header))
+		{
+			std::cerr << "SceneSerializer: " << path << " is too small to be a scene" << std::endl;
+			return false;
+		}
+
+		const auto& header = *reinterpret_cast<const SceneFormat::Header*>(data);
+		if (header.magic != SceneFormat::Magic || header.version != SceneFormat::Version)
+		{
+			std::cerr << "SceneSerializer: " << path << " is not a version " << SceneFormat::Version << " scene" << std::endl;
+			return false;
+		}
+
+		if (!IsSectionValid(header.objects, sizeof(SceneFormat::Object), size)
+			|| !IsSectionValid(header.transforms, sizeof(SceneFormat::Transform), size)
+			|| !IsSectionValid(header.components, sizeof(SceneFormat::Component), size)
+			|| !IsSectionValid(header.assets, sizeof(SceneFormat::Asset), size)
+			|| !IsSectionValid(header.componentData, 1, size)
+			|| !IsSectionValid(header.strings, 1, size)
+			|| header.transforms.count != header.objects.count
+			|| (header.mainCamera != SceneFormat::NoIndex && header.mainCamera >= header.objects.count))
+		{
+			std::cerr << "SceneSerializer: " << path << " has a corrupt header" << std::endl;
+			return false;
+		}
+
+		const auto* objects = SectionData<SceneFormat::Object>(data, header.objects);
+		const auto* transforms = SectionData<SceneFormat::Transform>(data, header.transforms);
+		const auto* components = SectionData<SceneFormat::Component>(data, header.components);
+		const auto* assets = SectionData<SceneFormat::Asset>(data, header.assets);
+		const uint8_t* componentData = data + header.componentData.offset;
+		const char* strings = reinterpret_cast<const char*>(data + header.strings.offset);
+		const size_t objectCount = static_cast<size_t>(header.objects.count);
+
+		// Validate every reference before creating anything, so a bad file leaves the scene untouched
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			const SceneFormat::Object& object = objects[i];
+			bool valid = (object.parent == SceneFormat::NoIndex || object.parent < i)
+				&& IsRangeValid(object.nameOffset, object.nameLength, header.strings.count)
+				&& IsRangeValid(object.firstComponent, object.componentCount, header.components.count);
+			for (uint32_t c = 0; valid && c < object.componentCount; ++c)
+			{
+				const SceneFormat::Component& component = components[object.firstComponent + c];
+				valid = IsRangeValid(component.dataOffset, component.dataSize, header.componentData.count);
+			}
+			if (!valid)
+			{
+				std::cerr << "SceneSerializer: " << path << " has a corrupt object record " << i << std::endl;
+				return false;
+			}
+		}
+
+		for (size_t i = 0; i < header.assets.count; ++i)
+		{
+			const SceneFormat::Asset& asset = assets[i];
+			const StringId name = StringId::FromHash(asset.name);
+			const bool found = asset.type == SceneFormat::AssetType::Mesh ? m_assets.FindMesh(name) != nullptr : m_assets.FindMaterial(name) != nullptr;
+			if (!found)
+			{
+				const std::string_view assetName = IsRangeValid(asset.nameOffset, asset.nameLength, header.strings.count)
+					? std::string_view(strings + asset.nameOffset, asset.nameLength) : std::string_view();
+				std::cerr << "SceneSerializer: " << path << " references missing asset '" << assetName << "'" << std::endl;
+			}
+		}
+
+		scene.Reserve(scene.GetObjectCount() + objectCount);
+
+		std::vector<GameObject*> created(objectCount);
+		std::unordered_set<uint64_t> unknownTypes;
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			const SceneFormat::Object& record = objects[i];
+			GameObject* parent = record.parent == SceneFormat::NoIndex ? nullptr : created[record.parent];
+			GameObject* object = scene.CreateObject(std::string_view(strings + record.nameOffset, record.nameLength), parent);
+			created[i] = object;
+
+			const SceneFormat::Transform& transform = transforms[i];
+			object->SetPosition(glm::vec3(transform.position[0], transform.position[1], transform.position[2]));
+			object->SetRotation(glm::quat(transform.rotation[3], transform.rotation[0], transform.rotation[1], transform.rotation[2]));
+			object->SetScale(glm::vec3(transform.scale[0], transform.scale[1], transform.scale[2]));
+
+			for (uint32_t c = 0; c < record.componentCount; ++c)
+			{
+				const SceneFormat::Component& component = components[record.firstComponent + c];
+				auto loader = m_loaders.find(StringId::FromHash(component.type));
+				if (loader == m_loaders.end())
+				{
+					if (unknownTypes.insert(component.type).second)
+					{
+						std::cerr << "SceneSerializer: " << path << " contains unregistered component type " << std::hex << component.type << std::dec << ", skipped" << std::endl;
+					}
+					continue;
+				}
+
+				ComponentReader reader(componentData + component.dataOffset, component.dataSize, m_assets);
+				if (!loader->second(*object, reader))
+				{
+					std::cerr << "SceneSerializer: " << path << " has truncated component data on object " << i << std::endl;
+				}
+			}
+		}
+
+		if (header.mainCamera != SceneFormat::NoIndex)
+		{
+			scene.SetMainCamera(created[header.mainCamera]);
+		}
+		return true;
+	}
+}
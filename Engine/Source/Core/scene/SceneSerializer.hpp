@@ -0,0 +1,161 @@
+#pragma once
+#include "Core/scene/SceneFormat.hpp"
+#include "Core/scene/Component.hpp"
+#include "Core/strings/StringId.hpp"
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace LEN
+{
+	class Scene;
+	class GameObject;
+	class Mesh;
+	class Material;
+
+	// Named meshes and materials a scene file can refer to. Assets are created by code (they own
+	// GPU resources), the file only stores their names.
+	class SceneAssets
+	{
+	public:
+		void AddMesh(std::string_view name, std::shared_ptr<Mesh> mesh);
+		void AddMaterial(std::string_view name, std::shared_ptr<Material> material);
+
+		std::shared_ptr<Mesh> FindMesh(StringId name) const;
+		std::shared_ptr<Material> FindMaterial(StringId name) const;
+
+		// Name the asset was added under, empty if it is unknown
+		StringId GetName(const void* asset) const;
+		std::string_view GetNameString(StringId name) const;
+
+	private:
+		struct Entry
+		{
+			std::string name;
+			SceneFormat::AssetType type;
+			std::shared_ptr<void> asset;
+		};
+
+		void Add(std::string_view name, SceneFormat::AssetType type, std::shared_ptr<void> asset);
+		std::shared_ptr<void> Find(StringId name, SceneFormat::AssetType type) const;
+
+		std::unordered_map<StringId, Entry> m_assets;
+		std::unordered_map<const void*, StringId> m_names;
+	};
+
+	// Serialized bytes of one component
+	class ComponentWriter
+	{
+	public:
+		ComponentWriter(std::vector<uint8_t>& data, const SceneAssets& assets);
+
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written");
+			const size_t offset = m_data.size();
+			m_data.resize(offset + sizeof(T));
+			std::memcpy(m_data.data() + offset, &value, sizeof(T));
+		}
+
+		// Stored as the name hash the asset was added under; unnamed assets are written as null
+		void WriteAsset(const Mesh* mesh);
+		void WriteAsset(const Material* material);
+
+		const std::vector<std::pair<StringId, SceneFormat::AssetType>>& GetReferencedAssets() const;
+
+	private:
+		void WriteAsset(const void* asset, SceneFormat::AssetType type);
+
+		std::vector<uint8_t>& m_data;
+		const SceneAssets& m_assets;
+		std::vector<std::pair<StringId, SceneFormat::AssetType>> m_referencedAssets;
+	};
+
+	// Reads the bytes written by the matching ComponentWriter calls straight from the mapped file
+	class ComponentReader
+	{
+	public:
+		ComponentReader(const uint8_t* data, size_t size, const SceneAssets& assets);
+
+		// Returns a value initialized T and flags the reader when the data is too short
+		template<typename T>
+		T Read()
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read");
+			T value{};
+			if (m_offset + sizeof(T) > m_size)
+			{
+				m_overrun = true;
+				return value;
+			}
+			std::memcpy(&value, m_data + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return value;
+		}
+
+		std::shared_ptr<Mesh> ReadMesh(); // nullptr if the asset is not registered
+		std::shared_ptr<Material> ReadMaterial();
+
+		bool IsValid() const; // False once a read ran past the end of the component data
+
+	private:
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_offset = 0;
+		bool m_overrun = false;
+		const SceneAssets& m_assets;
+	};
+
+	/************************************************************************
+	 *                        BINARY SCENE FILES                              *
+	 *  Save writes hierarchy, transforms, names and the data of registered  *
+	 *  components. Load maps the file and builds the objects in one pass:   *
+	 *  storage is reserved up front and every record is read in place, so  *
+	 *  the cost per object is the object itself, not parsing.               *
+	 *  Objects are loaded as plain GameObjects; components without a        *
+	 *  registered codec are skipped with a warning.                         *
+	 ************************************************************************/
+	class SceneSerializer
+	{
+	public:
+		template<typename T>
+		using SaveFunction = std::function<void(const T&, ComponentWriter&)>;
+		using LoadFunction = std::function<bool(GameObject&, ComponentReader&)>; // Adds the component
+
+		SceneSerializer(); // Registers the engine components
+
+		// typeName is stored in files by hash; renaming it breaks existing files
+		template<typename T, typename = typename std::enable_if_t<std::is_base_of_v<Component, T>>>
+		void RegisterComponent(std::string_view typeName, SaveFunction<T> save, LoadFunction load)
+		{
+			const StringId type(typeName);
+			m_savers[Component::StaticTypeId<T>()] = SaveEntry{ type, [save = std::move(save)](const Component& component, ComponentWriter& writer) {
+				save(static_cast<const T&>(component), writer);
+			} };
+			m_loaders[type] = std::move(load);
+		}
+
+		SceneAssets& GetAssets();
+		const SceneAssets& GetAssets() const;
+
+		bool Save(Scene& scene, const std::string& path) const;
+		bool Load(Scene& scene, const std::string& path) const; // Adds the file's objects to the scene
+
+	private:
+		struct SaveEntry
+		{
+			StringId type;
+			std::function<void(const Component&, ComponentWriter&)> save;
+		};
+
+		SceneAssets m_assets;
+		std::unordered_map<size_t, SaveEntry> m_savers; // By Component::GetTypeId()
+		std::unordered_map<StringId, LoadFunction> m_loaders; // By registered type name
+	};
+}
@@ -0,0 +1,672 @@
+#include "Core/scene/TransformStore.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define LEN_TRANSFORM_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace LEN
+{
+	namespace
+	{
+		constexpr uint32_t InvalidIndex = UINT32_MAX; // No parent / destroyed id
+
+		// Same composition as translate * rotateX * rotateY * rotateZ * scale
+		glm::quat EulerToQuat(const glm::vec3& rotation)
+		{
+			return glm::angleAxis(rotation.x, glm::vec3(1.0f, 0.0f, 0.0f))
+				* glm::angleAxis(rotation.y, glm::vec3(0.0f, 1.0f, 0.0f))
+				* glm::angleAxis(rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+		}
+
+		// Inverse of EulerToQuat. glm::eulerAngles decomposes in the Z*Y*X order instead, whose
+		// angles rebuild a different orientation here. Reads the angles off the rotation matrix
+		// Rx*Ry*Rz, whose row 0, column 2 is sin(y).
+		glm::vec3 QuatToEuler(const glm::quat& q)
+		{
+			const float r00 = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+			const float r01 = 2.0f * (q.x * q.y - q.w * q.z);
+			const float r02 = 2.0f * (q.x * q.z + q.w * q.y);
+			const float r10 = 2.0f * (q.x * q.y + q.w * q.z);
+			const float r11 = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+			const float r12 = 2.0f * (q.y * q.z - q.w * q.x);
+			const float r22 = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+
+			// atan2 rather than asin(r02), which loses precision towards +-90 degrees
+			const float cosY = std::sqrt(r00 * r00 + r01 * r01);
+			const float y = std::atan2(r02, cosY);
+			if (cosY < 1e-3f)
+			{
+				// Gimbal lock: x and z turn about the same axis, put all of it into x
+				return glm::vec3(std::atan2(r02 > 0.0f ? r10 : -r10, r11), y, 0.0f);
+			}
+			return glm::vec3(std::atan2(-r12, r22), y, std::atan2(-r01, r00));
+		}
+
+		// Same orientation; q and -q are the same rotation
+		bool SameRotation(const glm::quat& a, const glm::quat& b)
+		{
+			const float d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+			return std::abs(d) > 1.0f - 1e-4f;
+		}
+
+		// out = a * b, out must not alias a or b
+		inline void MultiplyMat4(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+		{
+#ifdef LEN_TRANSFORM_SSE
+			const float* pa = glm::value_ptr(a);
+			const float* pb = glm::value_ptr(b);
+			float* po = glm::value_ptr(out);
+
+			const __m128 a0 = _mm_loadu_ps(pa + 0);
+			const __m128 a1 = _mm_loadu_ps(pa + 4);
+			const __m128 a2 = _mm_loadu_ps(pa + 8);
+			const __m128 a3 = _mm_loadu_ps(pa + 12);
+
+			for (int column = 0; column < 4; ++column)
+			{
+				const float* b = pb + column * 4;
+				__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+				r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+				r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+				r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+				_mm_storeu_ps(po + column * 4, r);
+			}
+#else
+			out = a * b;
+#endif
+		}
+
+		// Decomposes both matrices into translation, rotation and scale (no shear) and blends those
+		glm::mat4 BlendMatrices(const glm::mat4& from, const glm::mat4& to, float alpha)
+		{
+			auto decompose = [](const glm::mat4& m, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) {
+				translation = glm::vec3(m[3]);
+				glm::vec3 axes[3] = { glm::vec3(m[0]), glm::vec3(m[1]), glm::vec3(m[2]) };
+				scale = glm::vec3(glm::length(axes[0]), glm::length(axes[1]), glm::length(axes[2]));
+				if (glm::dot(glm::cross(axes[0], axes[1]), axes[2]) < 0.0f)
+				{
+					scale.x = -scale.x; // Mirrored: keep the rotation proper
+				}
+
+				glm::mat3 basis(1.0f);
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					basis[axis] = scale[axis] != 0.0f ? axes[axis] / scale[axis] : basis[axis];
+				}
+				rotation = glm::quat_cast(basis);
+			};
+
+			glm::vec3 fromTranslation, toTranslation, fromScale, toScale;
+			glm::quat fromRotation, toRotation;
+			decompose(from, fromTranslation, fromRotation, fromScale);
+			decompose(to, toTranslation, toRotation, toScale);
+
+			const glm::vec3 scale = glm::mix(fromScale, toScale, alpha);
+			glm::mat4 result = glm::mat4_cast(glm::slerp(fromRotation, toRotation, alpha));
+			result[0] *= scale.x;
+			result[1] *= scale.y;
+			result[2] *= scale.z;
+			result[3] = glm::vec4(glm::mix(fromTranslation, toTranslation, alpha), 1.0f);
+			return result;
+		}
+
+		template<typename T>
+		void Permute(std::vector<T>& values, const std::vector<uint32_t>& order)
+		{
+			std::vector<T> result;
+			result.reserve(order.size());
+			for (uint32_t index : order)
+			{
+				result.push_back(values[index]);
+			}
+			values.swap(result);
+		}
+	}
+
+	TransformId TransformStore::Create()
+	{
+		TransformId id;
+		if (!m_freeIds.empty())
+		{
+			id = m_freeIds.back();
+			m_freeIds.pop_back();
+		}
+		else
+		{
+			id = static_cast<TransformId>(m_sparse.size());
+			m_sparse.push_back(InvalidIndex);
+			if (id == m_generations.size())
+			{
+				m_generations.push_back(0); // Kept by Clear, so ids handed out again continue their count
+			}
+		}
+
+		m_sparse[id] = static_cast<uint32_t>(m_ids.size());
+
+		m_ids.push_back(id);
+		m_parents.push_back(InvalidIndex);
+		m_childCounts.push_back(0);
+		m_positionX.push_back(0.0f);
+		m_positionY.push_back(0.0f);
+		m_positionZ.push_back(0.0f);
+		m_rotationX.push_back(0.0f);
+		m_rotationY.push_back(0.0f);
+		m_rotationZ.push_back(0.0f);
+		m_rotationW.push_back(1.0f);
+		m_scaleX.push_back(1.0f);
+		m_scaleY.push_back(1.0f);
+		m_scaleZ.push_back(1.0f);
+		m_eulerRotations.push_back(glm::vec3(0.0f));
+		m_localDirty.push_back(1);
+		m_worldDirty.push_back(1);
+		m_alive.push_back(1);
+		m_localMatrices.push_back(glm::mat4(1.0f));
+		m_worldMatrices.push_back(glm::mat4(1.0f));
+		m_previousWorldMatrices.push_back(glm::mat4(1.0f));
+		m_motion.push_back(Snap); // Nothing to blend from before the first Update
+
+		++m_liveCount;
+		return id;
+	}
+
+	void TransformStore::Destroy(TransformId id)
+	{
+		const uint32_t dense = Dense(id);
+		const uint32_t parent = ParentOf(dense);
+		if (parent != InvalidIndex)
+		{
+			--m_childCounts[parent];
+		}
+
+		m_sparse[id] = InvalidIndex;
+		m_freeIds.push_back(id);
+		++m_generations[id];
+		--m_liveCount;
+
+		// A leaf can be replaced by the last entry as long as that entry's parent still precedes it
+		const uint32_t last = static_cast<uint32_t>(m_ids.size() - 1);
+		const bool canSwapAndPop = !m_orderDirty && m_childCounts[dense] == 0
+			&& (dense == last || m_parents[last] == InvalidIndex || m_parents[last] < dense);
+
+		if (canSwapAndPop)
+		{
+			ForEachStream([dense, last](auto& stream) {
+				stream[dense] = stream[last];
+				stream.pop_back();
+			});
+			if (dense != last)
+			{
+				m_sparse[m_ids[dense]] = dense;
+			}
+			return;
+		}
+
+		m_alive[dense] = 0;
+		m_orderDirty = true; // Dead entries are compacted by the next Reorder
+	}
+
+	void TransformStore::SetParent(TransformId id, TransformId parent)
+	{
+		const uint32_t dense = Dense(id);
+		const uint32_t parentDense = parent == InvalidTransformId ? InvalidIndex : Dense(parent);
+
+		const uint32_t previousParent = ParentOf(dense);
+		if (previousParent != InvalidIndex)
+		{
+			--m_childCounts[previousParent];
+		}
+		if (parentDense != InvalidIndex)
+		{
+			++m_childCounts[parentDense];
+		}
+
+		m_parents[dense] = parentDense;
+		m_worldDirty[dense] = 1;
+
+		if (parentDense != InvalidIndex && parentDense > dense)
+		{
+			m_orderDirty = true; // Parent now comes after its child
+		}
+	}
+
+	glm::vec3 TransformStore::GetPosition(TransformId id) const
+	{
+		const uint32_t i = Dense(id);
+		return glm::vec3(m_positionX[i], m_positionY[i], m_positionZ[i]);
+	}
+
+	void TransformStore::SetPosition(TransformId id, const glm::vec3& position)
+	{
+		const uint32_t i = Dense(id);
+		m_positionX[i] = position.x;
+		m_positionY[i] = position.y;
+		m_positionZ[i] = position.z;
+		m_localDirty[i] = 1;
+		m_worldDirty[i] = 1;
+	}
+
+	glm::quat TransformStore::GetRotation(TransformId id) const
+	{
+		const uint32_t i = Dense(id);
+		return glm::quat(m_rotationW[i], m_rotationX[i], m_rotationY[i], m_rotationZ[i]);
+	}
+
+	void TransformStore::SetRotation(TransformId id, const glm::quat& rotation)
+	{
+		const uint32_t i = Dense(id);
+		const glm::quat q = glm::normalize(rotation);
+		m_rotationX[i] = q.x;
+		m_rotationY[i] = q.y;
+		m_rotationZ[i] = q.z;
+		m_rotationW[i] = q.w;
+		m_eulerRotations[i] = QuatToEuler(q);
+		assert(SameRotation(EulerToQuat(m_eulerRotations[i]), q) && "Euler angles must rebuild the rotation");
+		m_localDirty[i] = 1;
+		m_worldDirty[i] = 1;
+	}
+
+	glm::vec3 TransformStore::GetEulerRotation(TransformId id) const
+	{
+		return m_eulerRotations[Dense(id)];
+	}
+
+	void TransformStore::SetEulerRotation(TransformId id, const glm::vec3& rotation)
+	{
+		const uint32_t i = Dense(id);
+		const glm::quat q = EulerToQuat(rotation);
+		m_rotationX[i] = q.x;
+		m_rotationY[i] = q.y;
+		m_rotationZ[i] = q.z;
+		m_rotationW[i] = q.w;
+		m_eulerRotations[i] = rotation;
+		m_localDirty[i] = 1;
+		m_worldDirty[i] = 1;
+	}
+
+	glm::vec3 TransformStore::GetScale(TransformId id) const
+	{
+		const uint32_t i = Dense(id);
+		return glm::vec3(m_scaleX[i], m_scaleY[i], m_scaleZ[i]);
+	}
+
+	void TransformStore::SetScale(TransformId id, const glm::vec3& scale)
+	{
+		const uint32_t i = Dense(id);
+		m_scaleX[i] = scale.x;
+		m_scaleY[i] = scale.y;
+		m_scaleZ[i] = scale.z;
+		m_localDirty[i] = 1;
+		m_worldDirty[i] = 1;
+	}
+
+	glm::mat4 TransformStore::GetLocalMatrix(TransformId id) const
+	{
+		const uint32_t i = Dense(id);
+		return m_localDirty[i] ? ComposeLocal(i) : m_localMatrices[i];
+	}
+
+	glm::mat4 TransformStore::GetWorldMatrix(TransformId id) const
+	{
+		const uint32_t i = Dense(id);
+		return IsDirty(i) ? ComposeWorld(i) : m_worldMatrices[i];
+	}
+
+	glm::mat4 TransformStore::GetCommittedWorldMatrix(TransformId id) const
+	{
+		return m_worldMatrices[Dense(id)];
+	}
+
+	bool TransformStore::IsWorldDirty(TransformId id) const
+	{
+		return IsDirty(Dense(id));
+	}
+
+	size_t TransformStore::Update()
+	{
+		if (m_orderDirty)
+		{
+			Reorder();
+		}
+
+		UpdateLocalMatrices();
+
+		// Entries that moved in the previous pass and are not recomputed now stop blending
+		for (TransformId id : m_changedIds)
+		{
+			if (IsValid(id) && m_motion[m_sparse[id]] == Moved)
+			{
+				m_motion[m_sparse[id]] = Static;
+			}
+		}
+
+		// Parents precede children, so a parent's flag already says whether it changed this pass
+		m_changedIds.clear();
+		const size_t count = m_ids.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint32_t parent = m_parents[i];
+			if (parent != InvalidIndex && m_worldDirty[parent])
+			{
+				m_worldDirty[i] = 1;
+			}
+
+			if (!m_worldDirty[i])
+			{
+				continue;
+			}
+
+			// Children of an entry that snapped this pass snap with it; a recomputed parent is either Moved or snapped
+			const bool snap = m_motion[i] == Snap || (parent != InvalidIndex && m_worldDirty[parent] && m_motion[parent] != Moved);
+			m_previousWorldMatrices[i] = m_worldMatrices[i];
+			m_motion[i] = snap ? Static : Moved;
+			if (parent == InvalidIndex)
+			{
+				m_worldMatrices[i] = m_localMatrices[i];
+			}
+			else
+			{
+				MultiplyMat4(m_worldMatrices[parent], m_localMatrices[i], m_worldMatrices[i]);
+			}
+			m_changedIds.push_back(m_ids[i]);
+		}
+
+		std::fill(m_worldDirty.begin(), m_worldDirty.end(), uint8_t(0));
+		return m_changedIds.size();
+	}
+
+	const std::vector<TransformId>& TransformStore::GetChangedIds() const
+	{
+		return m_changedIds;
+	}
+
+	glm::mat4 TransformStore::GetInterpolatedWorldMatrix(TransformId id, float alpha) const
+	{
+		const uint32_t i = Dense(id);
+		if (m_motion[i] != Moved || alpha >= 1.0f || IsDirty(i))
+		{
+			return GetWorldMatrix(id);
+		}
+		return BlendMatrices(m_previousWorldMatrices[i], m_worldMatrices[i], std::max(alpha, 0.0f));
+	}
+
+	void TransformStore::ResetInterpolation(TransformId id)
+	{
+		const uint32_t i = Dense(id);
+		m_motion[i] = Snap;
+		m_worldDirty[i] = 1; // Recomputed, and snapped, by the next Update
+	}
+
+	bool TransformStore::IsValid(TransformId id) const
+	{
+		return id < m_sparse.size() && m_sparse[id] != InvalidIndex;
+	}
+
+	uint32_t TransformStore::GetGeneration(TransformId id) const
+	{
+		return id < m_generations.size() ? m_generations[id] : 0;
+	}
+
+	bool TransformStore::IsValid(TransformId id, uint32_t generation) const
+	{
+		return IsValid(id) && m_generations[id] == generation;
+	}
+
+	size_t TransformStore::GetSize() const
+	{
+		return m_liveCount;
+	}
+
+	void TransformStore::Reserve(size_t count)
+	{
+		m_sparse.reserve(count);
+		ForEachStream([count](auto& stream) { stream.reserve(count); });
+	}
+
+	void TransformStore::Clear()
+	{
+		ForEachStream([](auto& stream) { stream.clear(); });
+		m_sparse.clear();
+		m_freeIds.clear();
+		for (uint32_t& generation : m_generations)
+		{
+			++generation;
+		}
+		m_changedIds.clear();
+		m_liveCount = 0;
+		m_orderDirty = false;
+	}
+
+	uint32_t TransformStore::Dense(TransformId id) const
+	{
+		assert(id < m_sparse.size() && m_sparse[id] != InvalidIndex && "Invalid or destroyed TransformId");
+		return m_sparse[id];
+	}
+
+	glm::mat4 TransformStore::ComposeLocal(uint32_t i) const
+	{
+		glm::mat4 mat = glm::mat4_cast(glm::quat(m_rotationW[i], m_rotationX[i], m_rotationY[i], m_rotationZ[i]));
+		mat[0] *= m_scaleX[i];
+		mat[1] *= m_scaleY[i];
+		mat[2] *= m_scaleZ[i];
+		mat[3] = glm::vec4(m_positionX[i], m_positionY[i], m_positionZ[i], 1.0f);
+		return mat;
+	}
+
+	uint32_t TransformStore::ParentOf(uint32_t i) const
+	{
+		// A destroyed parent is only unlinked by the next Reorder; until then its child acts as a root
+		const uint32_t parent = m_parents[i];
+		return (parent != InvalidIndex && m_alive[parent]) ? parent : InvalidIndex;
+	}
+
+	bool TransformStore::IsDirty(uint32_t i) const
+	{
+		// Dirty flags are only propagated down the hierarchy by Update, so check the ancestors too
+		for (; i != InvalidIndex; i = ParentOf(i))
+		{
+			if (m_worldDirty[i])
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	glm::mat4 TransformStore::ComposeWorld(uint32_t i) const
+	{
+		const glm::mat4 local = m_localDirty[i] ? ComposeLocal(i) : m_localMatrices[i];
+		const uint32_t parent = ParentOf(i);
+		if (parent == InvalidIndex)
+		{
+			return local;
+		}
+		const glm::mat4 parentWorld = IsDirty(parent) ? ComposeWorld(parent) : m_worldMatrices[parent];
+		return parentWorld * local;
+	}
+
+	void TransformStore::UpdateLocalMatrices()
+	{
+		const size_t count = m_ids.size();
+		size_t i = 0;
+
+#ifdef LEN_TRANSFORM_SSE
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (; i + 4 <= count; i += 4)
+		{
+			// Clean lanes in a dirty batch are rebuilt from unchanged inputs, which yields the same matrix
+			if (!(m_localDirty[i] | m_localDirty[i + 1] | m_localDirty[i + 2] | m_localDirty[i + 3]))
+			{
+				continue;
+			}
+
+			const __m128 qx = _mm_loadu_ps(&m_rotationX[i]);
+			const __m128 qy = _mm_loadu_ps(&m_rotationY[i]);
+			const __m128 qz = _mm_loadu_ps(&m_rotationZ[i]);
+			const __m128 qw = _mm_loadu_ps(&m_rotationW[i]);
+			const __m128 sx = _mm_loadu_ps(&m_scaleX[i]);
+			const __m128 sy = _mm_loadu_ps(&m_scaleY[i]);
+			const __m128 sz = _mm_loadu_ps(&m_scaleZ[i]);
+
+			const __m128 xx = _mm_mul_ps(qx, qx);
+			const __m128 yy = _mm_mul_ps(qy, qy);
+			const __m128 zz = _mm_mul_ps(qz, qz);
+			const __m128 xy = _mm_mul_ps(qx, qy);
+			const __m128 xz = _mm_mul_ps(qx, qz);
+			const __m128 yz = _mm_mul_ps(qy, qz);
+			const __m128 wx = _mm_mul_ps(qw, qx);
+			const __m128 wy = _mm_mul_ps(qw, qy);
+			const __m128 wz = _mm_mul_ps(qw, qz);
+
+			// Column 0: (1 - 2(yy + zz), 2(xy + wz), 2(xz - wy)) * scale.x
+			__m128 c0 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+			__m128 c1 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+			__m128 c2 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+			__m128 c3 = zero;
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 0]) + 0, c0);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 1]) + 0, c1);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 2]) + 0, c2);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 3]) + 0, c3);
+
+			// Column 1: (2(xy - wz), 1 - 2(xx + zz), 2(yz + wx)) * scale.y
+			c0 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+			c1 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+			c2 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+			c3 = zero;
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 0]) + 4, c0);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 1]) + 4, c1);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 2]) + 4, c2);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 3]) + 4, c3);
+
+			// Column 2: (2(xz + wy), 2(yz - wx), 1 - 2(xx + yy)) * scale.z
+			c0 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+			c1 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+			c2 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+			c3 = zero;
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 0]) + 8, c0);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 1]) + 8, c1);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 2]) + 8, c2);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 3]) + 8, c3);
+
+			// Column 3: translation
+			c0 = _mm_loadu_ps(&m_positionX[i]);
+			c1 = _mm_loadu_ps(&m_positionY[i]);
+			c2 = _mm_loadu_ps(&m_positionZ[i]);
+			c3 = one;
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 0]) + 12, c0);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 1]) + 12, c1);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 2]) + 12, c2);
+			_mm_storeu_ps(glm::value_ptr(m_localMatrices[i + 3]) + 12, c3);
+
+			m_localDirty[i] = m_localDirty[i + 1] = m_localDirty[i + 2] = m_localDirty[i + 3] = 0;
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			if (m_localDirty[i])
+			{
+				m_localMatrices[i] = ComposeLocal(i);
+				m_localDirty[i] = 0;
+			}
+		}
+	}
+
+	void TransformStore::Reorder()
+	{
+		const size_t count = m_ids.size();
+
+		// Depth of every live entry; entries whose parent died become roots
+		std::vector<uint32_t> depths(count, InvalidIndex);
+		std::vector<uint32_t> chain;
+		uint32_t maxDepth = 0;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (!m_alive[i] || depths[i] != InvalidIndex)
+			{
+				continue;
+			}
+
+			chain.clear();
+			uint32_t current = i;
+			while (current != InvalidIndex && m_alive[current] && depths[current] == InvalidIndex)
+			{
+				chain.push_back(current);
+				current = m_parents[current];
+			}
+
+			uint32_t depth = (current != InvalidIndex && m_alive[current]) ? depths[current] + 1 : 0;
+			for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+			{
+				depths[*it] = depth++;
+			}
+			maxDepth = std::max(maxDepth, depth);
+		}
+
+		// Stable counting sort by depth keeps siblings in creation order
+		std::vector<uint32_t> offsets(maxDepth + 2, 0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_alive[i])
+			{
+				++offsets[depths[i] + 1];
+			}
+		}
+		for (size_t d = 1; d < offsets.size(); ++d)
+		{
+			offsets[d] += offsets[d - 1];
+		}
+
+		std::vector<uint32_t> order(m_liveCount);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_alive[i])
+			{
+				order[offsets[depths[i]]++] = i;
+			}
+		}
+
+		std::vector<uint32_t> remap(count, InvalidIndex);
+		for (uint32_t n = 0; n < order.size(); ++n)
+		{
+			remap[order[n]] = n;
+		}
+
+		ForEachStream([&order](auto& stream) { Permute(stream, order); });
+		std::fill(m_childCounts.begin(), m_childCounts.end(), 0u);
+
+		for (uint32_t n = 0; n < m_ids.size(); ++n)
+		{
+			m_sparse[m_ids[n]] = n;
+
+			const uint32_t parent = m_parents[n];
+			if (parent != InvalidIndex)
+			{
+				m_parents[n] = remap[parent];
+				if (m_parents[n] == InvalidIndex)
+				{
+					m_worldDirty[n] = 1; // Parent was destroyed: rebuild as a root
+				}
+				else
+				{
+					++m_childCounts[m_parents[n]];
+				}
+			}
+		}
+
+		m_orderDirty = false;
+	}
+}
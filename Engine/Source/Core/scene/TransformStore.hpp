@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace LEN
+{
+	using TransformId = uint32_t;
+	constexpr TransformId InvalidTransformId = UINT32_MAX;
+
+	// Structure-of-arrays storage for every transform of a scene.
+	// Entries are kept in hierarchy order (parents before children) so world matrices
+	// are composed in a single linear pass; local TRS matrices are built 4 at a time with SSE.
+	// TransformId is a stable handle, the dense position of an entry may change on reorder.
+	class TransformStore
+	{
+	public:
+		TransformId Create();
+		void Destroy(TransformId id);
+		void SetParent(TransformId id, TransformId parent); // InvalidTransformId makes the entry a root
+
+		glm::vec3 GetPosition(TransformId id) const;
+		void SetPosition(TransformId id, const glm::vec3& position);
+
+		glm::quat GetRotation(TransformId id) const;
+		void SetRotation(TransformId id, const glm::quat& rotation);
+
+		// Euler angles in radians, applied X then Y then Z (same order as the former per-object matrices)
+		glm::vec3 GetEulerRotation(TransformId id) const;
+		void SetEulerRotation(TransformId id, const glm::vec3& rotation);
+
+		glm::vec3 GetScale(TransformId id) const;
+		void SetScale(TransformId id, const glm::vec3& scale);
+
+		glm::mat4 GetLocalMatrix(TransformId id) const; // Cached, composed on the fly if dirty
+		glm::mat4 GetWorldMatrix(TransformId id) const; // Cached, composed on the fly if it or an ancestor is dirty
+		bool IsWorldDirty(TransformId id) const;
+		// World matrix as of the last Update pass, ignoring changes made since. Only Update writes
+		// it, so it can be read while other threads set transforms (see Scene's parallel update).
+		glm::mat4 GetCommittedWorldMatrix(TransformId id) const;
+
+		// Recompute dirty local matrices in SIMD batches, then dirty world matrices top-down.
+		// Returns the number of world matrices recomputed.
+		size_t Update();
+		const std::vector<TransformId>& GetChangedIds() const; // World matrices recomputed by the last Update
+
+		// World matrix blended between the two last Update passes: alpha 0 is the previous result,
+		// 1 the current one. Only entries changed by the last pass are blended (translation and scale
+		// lerped, rotation slerped), the others return their current matrix.
+		glm::mat4 GetInterpolatedWorldMatrix(TransformId id, float alpha) const;
+		void ResetInterpolation(TransformId id); // Next Update snaps instead of blending, e.g. after a teleport
+		bool IsValid(TransformId id) const; // False once the id has been destroyed
+		// Ids are reused after Destroy; the generation tells a reused id from the one handed out before
+		uint32_t GetGeneration(TransformId id) const;
+		bool IsValid(TransformId id, uint32_t generation) const; // False once that generation has been destroyed
+
+		size_t GetSize() const; // Number of live transforms
+		void Reserve(size_t count); // Capacity for count transforms in total, avoids regrowth on bulk creation
+		void Clear(); // Drops every entry at once; ids handed out before are invalid afterwards
+
+	private:
+		uint32_t Dense(TransformId id) const;
+		uint32_t ParentOf(uint32_t dense) const;
+		bool IsDirty(uint32_t dense) const;
+		glm::mat4 ComposeLocal(uint32_t dense) const;
+		glm::mat4 ComposeWorld(uint32_t dense) const;
+		void UpdateLocalMatrices();
+		void Reorder(); // Compact dead entries and restore parents-before-children order
+
+		// Calls fn on every dense stream that moves with an entry
+		template<typename Fn>
+		void ForEachStream(Fn&& fn)
+		{
+			fn(m_ids); fn(m_parents); fn(m_childCounts);
+			fn(m_positionX); fn(m_positionY); fn(m_positionZ);
+			fn(m_rotationX); fn(m_rotationY); fn(m_rotationZ); fn(m_rotationW);
+			fn(m_scaleX); fn(m_scaleY); fn(m_scaleZ);
+			fn(m_eulerRotations);
+			fn(m_localDirty); fn(m_worldDirty); fn(m_alive);
+			fn(m_localMatrices); fn(m_worldMatrices);
+			fn(m_previousWorldMatrices); fn(m_motion);
+		}
+
+		// Stable id -> dense index indirection
+		std::vector<uint32_t> m_sparse;
+		std::vector<TransformId> m_freeIds;
+		std::vector<uint32_t> m_generations; // Per id, bumped on Destroy and Clear
+
+		// Dense, hierarchy-ordered streams
+		std::vector<TransformId> m_ids;
+		std::vector<uint32_t> m_parents; // Dense index of the parent, UINT32_MAX for roots
+		std::vector<uint32_t> m_childCounts; // Live children, lets leaf entries be swap-and-popped
+		std::vector<float> m_positionX, m_positionY, m_positionZ;
+		std::vector<float> m_rotationX, m_rotationY, m_rotationZ, m_rotationW;
+		std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+		std::vector<glm::vec3> m_eulerRotations; // Cold: only read back by GetEulerRotation
+		std::vector<uint8_t> m_localDirty;
+		std::vector<uint8_t> m_worldDirty;
+		std::vector<uint8_t> m_alive;
+		std::vector<glm::mat4> m_localMatrices;
+		std::vector<glm::mat4> m_worldMatrices;
+
+		// World matrix before the last Update, only meaningful where m_motion is Moved
+		enum Motion : uint8_t { Static, Moved, Snap };
+		std::vector<glm::mat4> m_previousWorldMatrices;
+		std::vector<uint8_t> m_motion;
+
+		std::vector<TransformId> m_changedIds;
+		size_t m_liveCount = 0;
+		bool m_orderDirty = false;
+	};
+}
@@ -15,7 +15,35 @@ namespace LEN {
         // Assuming m_owner is a pointer to the GameObject this component is attached to
     }
 
+    glm::mat4 CameraComponent::GetViewMatrix(float interpolation) const {
+        return glm::inverse(m_owner->GetInterpolatedWorldTransform(interpolation));
+    }
+
     glm::mat4 CameraComponent::GetProjectionMatrix(float aspectRat) const {
         return glm::perspective(glm::radians(m_fov), aspectRat, m_nearPlane, m_farPlane);
     }
+
+    float CameraComponent::GetFov() const {
+        return m_fov;
+    }
+
+    void CameraComponent::SetFov(float fov) {
+        m_fov = fov;
+    }
+
+    float CameraComponent::GetNearPlane() const {
+        return m_nearPlane;
+    }
+
+    void CameraComponent::SetNearPlane(float nearPlane) {
+        m_nearPlane = nearPlane;
+    }
+
+    float CameraComponent::GetFarPlane() const {
+        return m_farPlane;
+    }
+
+    void CameraComponent::SetFarPlane(float farPlane) {
+        m_farPlane = farPlane;
+    }
 } // LEN
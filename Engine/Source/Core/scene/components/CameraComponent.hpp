@@ -14,9 +14,17 @@ namespace LEN {
         void Update(float deltaTime) override;
 
         glm::mat4 GetViewMatrix() const;
+        glm::mat4 GetViewMatrix(float interpolation) const; // From the owner's interpolated world transform
 
         glm::mat4 GetProjectionMatrix(float aspectRat) const;
 
+        float GetFov() const; // Vertical, in degrees
+        void SetFov(float fov);
+        float GetNearPlane() const;
+        void SetNearPlane(float nearPlane);
+        float GetFarPlane() const;
+        void SetFarPlane(float farPlane);
+
     private:
         float m_fov = 60.0f;
         float m_nearPlane = 0.1f;
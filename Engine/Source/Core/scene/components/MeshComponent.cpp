@@ -16,6 +16,12 @@ namespace LEN {
 
         }
 
+    MeshComponent::~MeshComponent() {
+        auto& renderQueue = Engine::GetInstance().GetRenderQueue();
+        renderQueue.ReleaseAfterDraw(std::move(m_mesh));
+        renderQueue.ReleaseAfterDraw(std::move(m_material));
+    }
+
     void MeshComponent::Update(float deltaTime) {
         if (!m_material || !m_mesh) return;
 
@@ -23,9 +29,24 @@ namespace LEN {
         cmd.material = m_material.get();
         cmd.mesh = m_mesh.get();
         cmd.modelMatrix = GetOwner()->GetWorldTransform(); // Get the world transform from the owner GameObject
+        cmd.transforms = &GetOwner()->GetScene()->GetTransforms();
+        cmd.transformId = GetOwner()->GetTransformId();
+        cmd.transformGeneration = cmd.transforms->GetGeneration(cmd.transformId);
+        if (m_mesh->HasBounds()) {
+            cmd.worldBounds = AABB::Transform(m_mesh->GetBounds(), cmd.modelMatrix); // Culled against the camera frustum
+            cmd.hasBounds = true;
+        }
 
         auto& renderQueue = Engine::GetInstance().GetRenderQueue();
         renderQueue.Submit(cmd);
     }
 
+    const std::shared_ptr<Material> &MeshComponent::GetMaterial() const {
+        return m_material;
+    }
+
+    const std::shared_ptr<Mesh> &MeshComponent::GetMesh() const {
+        return m_mesh;
+    }
+
 }
@@ -17,9 +17,13 @@ namespace LEN {
 
     public:
         MeshComponent(const std::shared_ptr<Material> &material, const std::shared_ptr<Mesh> &mesh);
+        ~MeshComponent() override; // Mesh and material stay alive until frames drawing them are done
 
         void Update(float deltaTime) override;
 
+        const std::shared_ptr<Material> &GetMaterial() const;
+        const std::shared_ptr<Mesh> &GetMesh() const;
+
     private:
         std::shared_ptr<Material> m_material;
         std::shared_ptr<Mesh> m_mesh;
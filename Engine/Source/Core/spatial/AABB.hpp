@@ -0,0 +1,65 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
+#include <cmath>
+
+namespace LEN
+{
+	// Axis aligned bounding box
+	struct AABB
+	{
+		glm::vec3 min = glm::vec3(0.0f);
+		glm::vec3 max = glm::vec3(0.0f);
+
+		glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+		float GetSurfaceArea() const
+		{
+			const glm::vec3 d = max - min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		bool Contains(const AABB& other) const
+		{
+			return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+				&& other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+		}
+
+		bool Overlaps(const AABB& other) const
+		{
+			return min.x <= other.max.x && other.min.x <= max.x
+				&& min.y <= other.max.y && other.min.y <= max.y
+				&& min.z <= other.max.z && other.min.z <= max.z;
+		}
+
+		AABB Expanded(float margin) const
+		{
+			return AABB{ min - glm::vec3(margin), max + glm::vec3(margin) };
+		}
+
+		static AABB Merge(const AABB& a, const AABB& b)
+		{
+			return AABB{ glm::min(a.min, b.min), glm::max(a.max, b.max) };
+		}
+
+		// Bounds of the box after an affine transform (Arvo's method)
+		static AABB Transform(const AABB& box, const glm::mat4& matrix)
+		{
+			const glm::vec3 center = box.GetCenter();
+			const glm::vec3 extents = box.GetExtents();
+			glm::vec3 newCenter(matrix[3]);
+			glm::vec3 newExtents(0.0f);
+			for (int column = 0; column < 3; ++column)
+			{
+				for (int row = 0; row < 3; ++row)
+				{
+					newCenter[row] += matrix[column][row] * center[column];
+					newExtents[row] += std::abs(matrix[column][row]) * extents[column];
+				}
+			}
+			return AABB{ newCenter - newExtents, newCenter + newExtents };
+		}
+	};
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
+
+namespace LEN
+{
+	struct BoundingSphere
+	{
+		glm::vec3 center = glm::vec3(0.0f);
+		float radius = 0.0f;
+
+		// Bounds of the sphere after an affine transform; non-uniform scale grows it to the largest axis
+		static BoundingSphere Transform(const BoundingSphere& sphere, const glm::mat4& matrix)
+		{
+			const float scale = std::max({ glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])) });
+			return BoundingSphere{ glm::vec3(matrix * glm::vec4(sphere.center, 1.0f)), sphere.radius * scale };
+		}
+	};
+}
@@ -0,0 +1,746 @@
+#include "Core/spatial/DynamicBVH.hpp"
+#include "Core/jobs/JobSystem.hpp"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define LEN_BVH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace LEN
+{
+	namespace
+	{
+		// Traversal stack that stays on the stack for any realistic tree height
+		class NodeStack
+		{
+		public:
+			void Push(int32_t node)
+			{
+				if (m_size < InlineCapacity)
+				{
+					m_inline[m_size++] = node;
+				}
+				else
+				{
+					m_overflow.push_back(node);
+				}
+			}
+
+			int32_t Pop()
+			{
+				if (!m_overflow.empty())
+				{
+					const int32_t node = m_overflow.back();
+					m_overflow.pop_back();
+					return node;
+				}
+				return m_inline[--m_size];
+			}
+
+			bool IsEmpty() const { return m_size == 0 && m_overflow.empty(); }
+
+		private:
+			static constexpr size_t InlineCapacity = 128;
+			int32_t m_inline[InlineCapacity];
+			size_t m_size = 0;
+			std::vector<int32_t> m_overflow;
+		};
+
+		// Lane 3 of every box and query is zero, so it never separates anything
+		inline bool Overlaps(const float* min, const float* max, const float* queryMin, const float* queryMax)
+		{
+#ifdef LEN_BVH_SSE
+			const __m128 separated = _mm_or_ps(
+				_mm_cmplt_ps(_mm_load_ps(max), _mm_load_ps(queryMin)),
+				_mm_cmplt_ps(_mm_load_ps(queryMax), _mm_load_ps(min)));
+			return (_mm_movemask_ps(separated) & 0x7) == 0;
+#else
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (max[axis] < queryMin[axis] || queryMax[axis] < min[axis])
+				{
+					return false;
+				}
+			}
+			return true;
+#endif
+		}
+
+		inline float DistanceSquared(const float* min, const float* max, const float* point)
+		{
+#ifdef LEN_BVH_SSE
+			const __m128 p = _mm_load_ps(point);
+			__m128 d = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(min), p), _mm_sub_ps(p, _mm_load_ps(max))), _mm_setzero_ps());
+			d = _mm_mul_ps(d, d);
+			__m128 sum = _mm_add_ps(d, _mm_movehl_ps(d, d));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+			return _mm_cvtss_f32(sum);
+#else
+			float distance = 0.0f;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const float d = std::max({ min[axis] - point[axis], point[axis] - max[axis], 0.0f });
+				distance += d * d;
+			}
+			return distance;
+#endif
+		}
+
+		// Slab test; on a hit enter is the distance at which the ray enters the box (0 if inside)
+		inline bool RayHits(const float* min, const float* max, const float* origin, const float* inverseDirection, float maxDistance, float& enter)
+		{
+#ifdef LEN_BVH_SSE
+			const __m128 o = _mm_load_ps(origin);
+			const __m128 inv = _mm_load_ps(inverseDirection);
+			const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min), o), inv);
+			const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max), o), inv);
+			// Lane 3 is padding; replace it with lane 0 before reducing
+			__m128 tNear = _mm_min_ps(t1, t2);
+			__m128 tFar = _mm_max_ps(t1, t2);
+			tNear = _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(0, 2, 1, 0));
+			tFar = _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(0, 2, 1, 0));
+			tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 0, 3, 2)));
+			tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+			tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 0, 3, 2)));
+			tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+			const float nearT = _mm_cvtss_f32(tNear);
+			const float farT = _mm_cvtss_f32(tFar);
+#else
+			float nearT = -FLT_MAX;
+			float farT = FLT_MAX;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const float t1 = (min[axis] - origin[axis]) * inverseDirection[axis];
+				const float t2 = (max[axis] - origin[axis]) * inverseDirection[axis];
+				nearT = std::max(nearT, std::min(t1, t2));
+				farT = std::min(farT, std::max(t1, t2));
+			}
+#endif
+			enter = std::max(nearT, 0.0f);
+			return enter <= farT && enter <= maxDistance;
+		}
+
+		struct alignas(16) Lanes
+		{
+			float values[4];
+		};
+
+		Lanes ToLanes(const glm::vec3& v)
+		{
+			return Lanes{ { v.x, v.y, v.z, 0.0f } };
+		}
+
+		Lanes InverseDirection(const glm::vec3& direction)
+		{
+			Lanes inverse{};
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				inverse.values[axis] = direction[axis] != 0.0f ? 1.0f / direction[axis] : FLT_MAX;
+			}
+			return inverse;
+		}
+	}
+
+	DynamicBVH::DynamicBVH(float fatMargin)
+		: m_fatMargin(fatMargin)
+	{
+	}
+
+	ProxyId DynamicBVH::CreateProxy(const AABB& bounds, void* userData)
+	{
+		const int32_t leaf = AllocateNode();
+		m_tightBounds[leaf] = ToBox(bounds);
+		m_nodes[leaf].bounds = ToBox(bounds.Expanded(m_fatMargin));
+		m_nodes[leaf].userData = userData;
+		m_nodes[leaf].height = 0;
+		InsertLeaf(leaf);
+		++m_proxyCount;
+		return leaf;
+	}
+
+	void DynamicBVH::DestroyProxy(ProxyId proxy)
+	{
+		assert(proxy >= 0 && proxy < static_cast<ProxyId>(m_nodes.size()) && m_nodes[proxy].IsLeaf());
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		--m_proxyCount;
+	}
+
+	bool DynamicBVH::MoveProxy(ProxyId proxy, const AABB& bounds, const glm::vec3& displacement)
+	{
+		assert(proxy >= 0 && proxy < static_cast<ProxyId>(m_nodes.size()) && m_nodes[proxy].IsLeaf());
+		m_tightBounds[proxy] = ToBox(bounds);
+
+		const AABB fat = ToAABB(m_nodes[proxy].bounds);
+		if (fat.Contains(bounds))
+		{
+			// Still inside, unless the fat box has grown far too large for the object
+			const AABB huge = bounds.Expanded(4.0f * m_fatMargin);
+			if (huge.Contains(fat))
+			{
+				return false;
+			}
+		}
+
+		AABB newFat = bounds.Expanded(m_fatMargin);
+		const glm::vec3 predicted = displacement * 2.0f;
+		newFat.min = glm::min(newFat.min, newFat.min + predicted);
+		newFat.max = glm::max(newFat.max, newFat.max + predicted);
+
+		RemoveLeaf(proxy);
+		m_nodes[proxy].bounds = ToBox(newFat);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicBVH::Clear()
+	{
+		m_nodes.clear();
+		m_tightBounds.clear();
+		m_root = NullProxy;
+		m_freeList = NullProxy;
+		m_proxyCount = 0;
+	}
+
+	void* DynamicBVH::GetUserData(ProxyId proxy) const
+	{
+		return m_nodes[proxy].userData;
+	}
+
+	AABB DynamicBVH::GetBounds(ProxyId proxy) const
+	{
+		return ToAABB(m_tightBounds[proxy]);
+	}
+
+	AABB DynamicBVH::GetFatBounds(ProxyId proxy) const
+	{
+		return ToAABB(m_nodes[proxy].bounds);
+	}
+
+	size_t DynamicBVH::GetProxyCount() const
+	{
+		return m_proxyCount;
+	}
+
+	int32_t DynamicBVH::GetHeight() const
+	{
+		return m_root == NullProxy ? 0 : m_nodes[m_root].height;
+	}
+
+	void DynamicBVH::QueryOverlap(const AABB& box, OverlapCallback callback, void* context) const
+	{
+		if (m_root == NullProxy)
+		{
+			return;
+		}
+
+		const Box query = ToBox(box);
+		NodeStack stack;
+		stack.Push(m_root);
+		while (!stack.IsEmpty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = m_nodes[index];
+			if (!Overlaps(node.bounds.min, node.bounds.max, query.min, query.max))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				const Box& tight = m_tightBounds[index];
+				if (Overlaps(tight.min, tight.max, query.min, query.max) && !callback(context, index))
+				{
+					return;
+				}
+			}
+			else
+			{
+				stack.Push(node.child1);
+				stack.Push(node.child2);
+			}
+		}
+	}
+
+	void DynamicBVH::QuerySphere(const glm::vec3& center, float radius, OverlapCallback callback, void* context) const
+	{
+		if (m_root == NullProxy)
+		{
+			return;
+		}
+
+		const Lanes point = ToLanes(center);
+		const float radiusSquared = radius * radius;
+		NodeStack stack;
+		stack.Push(m_root);
+		while (!stack.IsEmpty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = m_nodes[index];
+			if (DistanceSquared(node.bounds.min, node.bounds.max, point.values) > radiusSquared)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				const Box& tight = m_tightBounds[index];
+				if (DistanceSquared(tight.min, tight.max, point.values) <= radiusSquared && !callback(context, index))
+				{
+					return;
+				}
+			}
+			else
+			{
+				stack.Push(node.child1);
+				stack.Push(node.child2);
+			}
+		}
+	}
+
+	void DynamicBVH::Raycast(const Ray& ray, RaycastCallback callback, void* context) const
+	{
+		if (m_root == NullProxy)
+		{
+			return;
+		}
+
+		const Lanes origin = ToLanes(ray.origin);
+		const Lanes inverseDirection = InverseDirection(ray.direction);
+		float maxDistance = ray.maxDistance;
+
+		NodeStack stack;
+		stack.Push(m_root);
+		while (!stack.IsEmpty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = m_nodes[index];
+			float enter = 0.0f;
+			if (!RayHits(node.bounds.min, node.bounds.max, origin.values, inverseDirection.values, maxDistance, enter))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				const Box& tight = m_tightBounds[index];
+				if (RayHits(tight.min, tight.max, origin.values, inverseDirection.values, maxDistance, enter))
+				{
+					maxDistance = callback(context, index, enter);
+					if (maxDistance <= 0.0f)
+					{
+						return;
+					}
+				}
+			}
+			else
+			{
+				stack.Push(node.child1);
+				stack.Push(node.child2);
+			}
+		}
+	}
+
+	bool DynamicBVH::RaycastClosest(const Ray& ray, RayHit& hit) const
+	{
+		hit = RayHit{};
+		Raycast(ray, [&hit](ProxyId proxy, float distance) {
+			if (distance < hit.distance)
+			{
+				hit.proxy = proxy;
+				hit.distance = distance;
+			}
+			// Zero would stop the query, so a hit at the origin keeps a tiny positive limit
+			return std::max(hit.distance, FLT_MIN);
+		});
+		return hit.proxy != NullProxy;
+	}
+
+	size_t DynamicBVH::QueryNearest(const glm::vec3& point, size_t k, ProxyId* out, float maxDistance) const
+	{
+		if (m_root == NullProxy || k == 0)
+		{
+			return 0;
+		}
+
+		using Entry = std::pair<float, int32_t>; // Squared distance, node
+		// Reused across queries so batched queries do not allocate
+		thread_local std::vector<Entry> open;
+		thread_local std::vector<Entry> best;
+		open.clear();
+		best.clear();
+
+		const Lanes p = ToLanes(point);
+		const float maxSquared = maxDistance < FLT_MAX ? maxDistance * maxDistance : FLT_MAX;
+		auto limit = [&]() { return best.size() == k ? best.front().first : maxSquared; };
+
+		// open is a min-heap on distance, best a max-heap of the k closest found so far
+		open.emplace_back(DistanceSquared(m_nodes[m_root].bounds.min, m_nodes[m_root].bounds.max, p.values), m_root);
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), std::greater<Entry>());
+			const Entry entry = open.back();
+			open.pop_back();
+			if (entry.first > limit())
+			{
+				break; // Everything left is farther than the current k-th result
+			}
+
+			const Node& node = m_nodes[entry.second];
+			if (node.IsLeaf())
+			{
+				const Box& tight = m_tightBounds[entry.second];
+				const float distance = DistanceSquared(tight.min, tight.max, p.values);
+				if (distance <= limit())
+				{
+					best.emplace_back(distance, entry.second);
+					std::push_heap(best.begin(), best.end());
+					if (best.size() > k)
+					{
+						std::pop_heap(best.begin(), best.end());
+						best.pop_back();
+					}
+				}
+				continue;
+			}
+
+			for (int32_t child : { node.child1, node.child2 })
+			{
+				const float distance = DistanceSquared(m_nodes[child].bounds.min, m_nodes[child].bounds.max, p.values);
+				if (distance <= limit())
+				{
+					open.emplace_back(distance, child);
+					std::push_heap(open.begin(), open.end(), std::greater<Entry>());
+				}
+			}
+		}
+
+		std::sort_heap(best.begin(), best.end());
+		for (size_t i = 0; i < best.size(); ++i)
+		{
+			out[i] = best[i].second;
+		}
+		return best.size();
+	}
+
+	void DynamicBVH::RaycastBatch(const Ray* rays, RayHit* hits, size_t count, JobSystem* jobSystem, size_t grainSize) const
+	{
+		auto body = [this, rays, hits](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				RaycastClosest(rays[i], hits[i]);
+			}
+		};
+
+		if (jobSystem)
+		{
+			jobSystem->ParallelFor(0, count, grainSize, body);
+		}
+		else
+		{
+			body(0, count);
+		}
+	}
+
+	void DynamicBVH::QueryNearestBatch(const glm::vec3* points, size_t count, size_t k, ProxyId* results, JobSystem* jobSystem, size_t grainSize) const
+	{
+		auto body = [this, points, k, results](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				ProxyId* out = results + i * k;
+				const size_t found = QueryNearest(points[i], k, out);
+				std::fill(out + found, out + k, NullProxy);
+			}
+		};
+
+		if (jobSystem)
+		{
+			jobSystem->ParallelFor(0, count, grainSize, body);
+		}
+		else
+		{
+			body(0, count);
+		}
+	}
+
+	int32_t DynamicBVH::AllocateNode()
+	{
+		if (m_freeList == NullProxy)
+		{
+			m_nodes.emplace_back();
+			m_tightBounds.emplace_back();
+			m_nodes.back().parent = NullProxy;
+			m_nodes.back().height = -1;
+			m_freeList = static_cast<int32_t>(m_nodes.size() - 1);
+		}
+
+		const int32_t node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+		m_nodes[node].parent = NullProxy;
+		m_nodes[node].child1 = NullProxy;
+		m_nodes[node].child2 = NullProxy;
+		m_nodes[node].height = 0;
+		m_nodes[node].userData = nullptr;
+		return node;
+	}
+
+	void DynamicBVH::FreeNode(int32_t node)
+	{
+		m_nodes[node].parent = m_freeList;
+		m_nodes[node].height = -1;
+		m_freeList = node;
+	}
+
+	void DynamicBVH::InsertLeaf(int32_t leaf)
+	{
+		if (m_root == NullProxy)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = NullProxy;
+			return;
+		}
+
+		// Descend towards the sibling with the lowest surface area cost
+		const Box leafBounds = m_nodes[leaf].bounds;
+		int32_t index = m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const Node& node = m_nodes[index];
+			const float area = SurfaceArea(node.bounds);
+			const float combinedArea = SurfaceArea(Merge(node.bounds, leafBounds));
+
+			const float cost = 2.0f * combinedArea; // New parent for this node and the leaf
+			const float inheritanceCost = 2.0f * (combinedArea - area); // Growth pushed onto the ancestors
+
+			auto descendCost = [&](int32_t child) {
+				const Node& childNode = m_nodes[child];
+				const float merged = SurfaceArea(Merge(leafBounds, childNode.bounds));
+				return (childNode.IsLeaf() ? merged : merged - SurfaceArea(childNode.bounds)) + inheritanceCost;
+			};
+			const float cost1 = descendCost(node.child1);
+			const float cost2 = descendCost(node.child2);
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		const int32_t sibling = index;
+		const int32_t oldParent = m_nodes[sibling].parent;
+		const int32_t newParent = AllocateNode();
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].bounds = Merge(leafBounds, m_nodes[sibling].bounds);
+		m_nodes[newParent].height = m_nodes[sibling].height + 1;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == NullProxy)
+		{
+			m_root = newParent;
+		}
+		else if (m_nodes[oldParent].child1 == sibling)
+		{
+			m_nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			m_nodes[oldParent].child2 = newParent;
+		}
+
+		Refit(m_nodes[leaf].parent);
+	}
+
+	void DynamicBVH::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NullProxy;
+			return;
+		}
+
+		const int32_t parent = m_nodes[leaf].parent;
+		const int32_t grandParent = m_nodes[parent].parent;
+		const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		if (grandParent == NullProxy)
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = NullProxy;
+			FreeNode(parent);
+			return;
+		}
+
+		if (m_nodes[grandParent].child1 == parent)
+		{
+			m_nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			m_nodes[grandParent].child2 = sibling;
+		}
+		m_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+
+	void DynamicBVH::Refit(int32_t index)
+	{
+		while (index != NullProxy)
+		{
+			index = Balance(index);
+
+			Node& node = m_nodes[index];
+			node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+			node.bounds = Merge(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+			index = node.parent;
+		}
+	}
+
+	// Rotates the taller grandchild up when A's subtrees differ in height by more than one.
+	// Returns the index of the node now at A's position.
+	int32_t DynamicBVH::Balance(int32_t iA)
+	{
+		Node& A = m_nodes[iA];
+		if (A.IsLeaf() || A.height < 2)
+		{
+			return iA;
+		}
+
+		const int32_t iB = A.child1;
+		const int32_t iC = A.child2;
+		Node& B = m_nodes[iB];
+		Node& C = m_nodes[iC];
+		const int32_t balance = C.height - B.height;
+
+		auto replaceChild = [this](int32_t parent, int32_t oldChild, int32_t newChild) {
+			if (parent == NullProxy)
+			{
+				m_root = newChild;
+			}
+			else if (m_nodes[parent].child1 == oldChild)
+			{
+				m_nodes[parent].child1 = newChild;
+			}
+			else
+			{
+				m_nodes[parent].child2 = newChild;
+			}
+		};
+
+		if (balance > 1)
+		{
+			// Rotate C up
+			const int32_t iF = C.child1;
+			const int32_t iG = C.child2;
+			Node& F = m_nodes[iF];
+			Node& G = m_nodes[iG];
+
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+			replaceChild(C.parent, iA, iC);
+
+			if (F.height > G.height)
+			{
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+				A.bounds = Merge(B.bounds, G.bounds);
+				C.bounds = Merge(A.bounds, F.bounds);
+				A.height = 1 + std::max(B.height, G.height);
+				C.height = 1 + std::max(A.height, F.height);
+			}
+			else
+			{
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+				A.bounds = Merge(B.bounds, F.bounds);
+				C.bounds = Merge(A.bounds, G.bounds);
+				A.height = 1 + std::max(B.height, F.height);
+				C.height = 1 + std::max(A.height, G.height);
+			}
+			return iC;
+		}
+
+		if (balance < -1)
+		{
+			// Rotate B up
+			const int32_t iD = B.child1;
+			const int32_t iE = B.child2;
+			Node& D = m_nodes[iD];
+			Node& E = m_nodes[iE];
+
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+			replaceChild(B.parent, iA, iB);
+
+			if (D.height > E.height)
+			{
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+				A.bounds = Merge(C.bounds, E.bounds);
+				B.bounds = Merge(A.bounds, D.bounds);
+				A.height = 1 + std::max(C.height, E.height);
+				B.height = 1 + std::max(A.height, D.height);
+			}
+			else
+			{
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+				A.bounds = Merge(C.bounds, D.bounds);
+				B.bounds = Merge(A.bounds, E.bounds);
+				A.height = 1 + std::max(C.height, D.height);
+				B.height = 1 + std::max(A.height, E.height);
+			}
+			return iB;
+		}
+
+		return iA;
+	}
+
+	DynamicBVH::Box DynamicBVH::ToBox(const AABB& bounds)
+	{
+		return Box{ { bounds.min.x, bounds.min.y, bounds.min.z, 0.0f }, { bounds.max.x, bounds.max.y, bounds.max.z, 0.0f } };
+	}
+
+	AABB DynamicBVH::ToAABB(const Box& box)
+	{
+		return AABB{ glm::vec3(box.min[0], box.min[1], box.min[2]), glm::vec3(box.max[0], box.max[1], box.max[2]) };
+	}
+
+	DynamicBVH::Box DynamicBVH::Merge(const Box& a, const Box& b)
+	{
+		Box merged;
+#ifdef LEN_BVH_SSE
+		_mm_store_ps(merged.min, _mm_min_ps(_mm_load_ps(a.min), _mm_load_ps(b.min)));
+		_mm_store_ps(merged.max, _mm_max_ps(_mm_load_ps(a.max), _mm_load_ps(b.max)));
+#else
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			merged.min[lane] = std::min(a.min[lane], b.min[lane]);
+			merged.max[lane] = std::max(a.max[lane], b.max[lane]);
+		}
+#endif
+		return merged;
+	}
+
+	float DynamicBVH::SurfaceArea(const Box& box)
+	{
+		const float dx = box.max[0] - box.min[0];
+		const float dy = box.max[1] - box.min[1];
+		const float dz = box.max[2] - box.min[2];
+		return 2.0f * (dx * dy + dy * dz + dz * dx);
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "Core/spatial/AABB.hpp"
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LEN
+{
+	class JobSystem;
+
+	using ProxyId = int32_t;
+	constexpr ProxyId NullProxy = -1;
+
+	struct Ray
+	{
+		glm::vec3 origin = glm::vec3(0.0f);
+		glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f); // Need not be normalized; distances are in units of its length
+		float maxDistance = FLT_MAX;
+	};
+
+	struct RayHit
+	{
+		ProxyId proxy = NullProxy;
+		float distance = FLT_MAX;
+	};
+
+	// Dynamic AABB tree. Leaves hold a tight box plus a fattened copy used for the tree structure,
+	// so small moves do not touch the tree at all. Insertion picks the sibling with the lowest
+	// surface area cost, and AVL style rotations keep the height logarithmic.
+	// All const queries may run concurrently; Create/Destroy/Move may not.
+	class DynamicBVH
+	{
+	public:
+		explicit DynamicBVH(float fatMargin = 0.1f);
+
+		ProxyId CreateProxy(const AABB& bounds, void* userData);
+		void DestroyProxy(ProxyId proxy);
+		// Updates the tight bounds. Reinserts only when they leave the fat bounds; the fat box is
+		// then stretched along displacement to anticipate further motion. Returns true on reinsert.
+		bool MoveProxy(ProxyId proxy, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.0f));
+		void Clear();
+
+		void* GetUserData(ProxyId proxy) const;
+		AABB GetBounds(ProxyId proxy) const; // Tight
+		AABB GetFatBounds(ProxyId proxy) const;
+		size_t GetProxyCount() const;
+		int32_t GetHeight() const;
+
+		// fn(ProxyId) for every proxy whose tight bounds overlap; return false from fn to stop
+		template<typename Fn>
+		void QueryOverlap(const AABB& box, Fn&& fn) const
+		{
+			QueryOverlap(box, [](void* context, ProxyId proxy) { return (*static_cast<Fn*>(context))(proxy); }, &fn);
+		}
+
+		template<typename Fn>
+		void QuerySphere(const glm::vec3& center, float radius, Fn&& fn) const
+		{
+			QuerySphere(center, radius, [](void* context, ProxyId proxy) { return (*static_cast<Fn*>(context))(proxy); }, &fn);
+		}
+
+		// fn(ProxyId, distance) for every proxy whose tight bounds the ray enters, in no particular
+		// order. fn returns the new maximum distance: return distance to keep only closer hits,
+		// the current maximum to see all of them, or 0 to stop.
+		template<typename Fn>
+		void Raycast(const Ray& ray, Fn&& fn) const
+		{
+			Raycast(ray, [](void* context, ProxyId proxy, float distance) { return (*static_cast<Fn*>(context))(proxy, distance); }, &fn);
+		}
+
+		bool RaycastClosest(const Ray& ray, RayHit& hit) const;
+
+		// Up to k proxies ordered by distance from point to their tight bounds; returns the count written
+		size_t QueryNearest(const glm::vec3& point, size_t k, ProxyId* out, float maxDistance = FLT_MAX) const;
+
+		// Batched versions, split across the job system when one is given. QueryNearestBatch writes
+		// k results per point, padded with NullProxy.
+		void RaycastBatch(const Ray* rays, RayHit* hits, size_t count, JobSystem* jobSystem = nullptr, size_t grainSize = 64) const;
+		void QueryNearestBatch(const glm::vec3* points, size_t count, size_t k, ProxyId* results, JobSystem* jobSystem = nullptr, size_t grainSize = 64) const;
+
+	private:
+		using OverlapCallback = bool (*)(void* context, ProxyId proxy);
+		using RaycastCallback = float (*)(void* context, ProxyId proxy, float distance);
+
+		// Bounds padded to four lanes so the traversal can test them with one SSE compare
+		struct alignas(16) Box
+		{
+			float min[4];
+			float max[4];
+		};
+
+		struct Node
+		{
+			Box bounds;
+			void* userData;
+			int32_t parent; // Next free node while on the free list
+			int32_t child1;
+			int32_t child2;
+			int32_t height; // 0 for leaves, -1 while free
+
+			bool IsLeaf() const { return child1 == NullProxy; }
+		};
+
+		void QueryOverlap(const AABB& box, OverlapCallback callback, void* context) const;
+		void QuerySphere(const glm::vec3& center, float radius, OverlapCallback callback, void* context) const;
+		void Raycast(const Ray& ray, RaycastCallback callback, void* context) const;
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t node);
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		int32_t Balance(int32_t index);
+		void Refit(int32_t index); // Recomputes bounds and heights from index up to the root
+
+		static Box ToBox(const AABB& bounds);
+		static AABB ToAABB(const Box& box);
+		static Box Merge(const Box& a, const Box& b);
+		static float SurfaceArea(const Box& box);
+
+		std::vector<Node> m_nodes;
+		std::vector<Box> m_tightBounds; // Indexed by node, valid for leaves
+		int32_t m_root = NullProxy;
+		int32_t m_freeList = NullProxy;
+		size_t m_proxyCount = 0;
+		float m_fatMargin;
+	};
+}
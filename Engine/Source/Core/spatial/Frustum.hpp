@@ -0,0 +1,74 @@
+#pragma once
+#include "Core/spatial/AABB.hpp"
+#include "Core/spatial/BoundingSphere.hpp"
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+#include <cmath>
+
+namespace LEN
+{
+	// Six planes, xyz = inward normal and w = distance.
+	// Tests are conservative: a box near a frustum corner may be reported visible.
+	struct Frustum
+	{
+		enum PlaneIndex { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+		glm::vec4 planes[PlaneCount];
+
+		// Gribb/Hartmann extraction from an OpenGL style (-w..w depth) view projection matrix
+		static Frustum FromMatrix(const glm::mat4& viewProjection)
+		{
+			auto row = [&viewProjection](int i) {
+				return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+			};
+
+			Frustum frustum;
+			frustum.planes[Left] = row(3) + row(0);
+			frustum.planes[Right] = row(3) - row(0);
+			frustum.planes[Bottom] = row(3) + row(1);
+			frustum.planes[Top] = row(3) - row(1);
+			frustum.planes[Near] = row(3) + row(2);
+			frustum.planes[Far] = row(3) - row(2);
+
+			// Normalized so sphere radii can be compared against plane distances
+			for (auto& plane : frustum.planes)
+			{
+				const float length = glm::length(glm::vec3(plane));
+				if (length > 0.0f)
+				{
+					plane /= length;
+				}
+			}
+			return frustum;
+		}
+
+		bool Intersects(const AABB& box) const
+		{
+			const glm::vec3 center = box.GetCenter();
+			const glm::vec3 extents = box.GetExtents();
+			for (const auto& plane : planes)
+			{
+				const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+				const float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+				if (distance + radius < 0.0f)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool Intersects(const BoundingSphere& sphere) const
+		{
+			for (const auto& plane : planes)
+			{
+				if (glm::dot(glm::vec3(plane), sphere.center) + plane.w + sphere.radius < 0.0f)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+}
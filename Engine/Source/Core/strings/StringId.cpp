@@ -0,0 +1,68 @@
+#include "Core/strings/StringId.hpp"
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace LEN
+{
+	namespace
+	{
+		// Nodes never move, so views into the stored strings stay valid while the table grows
+		struct StringTable
+		{
+			std::shared_mutex mutex;
+			std::unordered_map<uint64_t, std::string> strings;
+		};
+
+		StringTable& GetTable()
+		{
+			static StringTable table;
+			return table;
+		}
+	}
+
+	StringId StringId::Intern(std::string_view text)
+	{
+		StringId id;
+		id.m_hash = Hash(text);
+		Register(id.m_hash, text);
+		return id;
+	}
+
+	std::string_view StringId::GetString() const
+	{
+		StringTable& table = GetTable();
+		std::shared_lock lock(table.mutex);
+		auto it = table.strings.find(m_hash);
+		return it != table.strings.end() ? std::string_view(it->second) : std::string_view();
+	}
+
+	void StringId::Register(uint64_t hash, std::string_view text)
+	{
+		if (hash == 0)
+		{
+			return;
+		}
+
+		StringTable& table = GetTable();
+		{
+			std::shared_lock lock(table.mutex);
+			auto it = table.strings.find(hash);
+			if (it != table.strings.end())
+			{
+				if (it->second != text)
+				{
+					std::cerr << "StringId collision: \"" << it->second << "\" and \"" << text << "\"" << std::endl;
+					assert(false && "StringId hash collision");
+				}
+				return;
+			}
+		}
+
+		std::unique_lock lock(table.mutex);
+		table.strings.try_emplace(hash, text);
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// Debug builds remember the text of every id hashed at runtime and check for collisions
+#ifndef LEN_STRINGID_DEBUG
+	#ifdef NDEBUG
+		#define LEN_STRINGID_DEBUG 0
+	#else
+		#define LEN_STRINGID_DEBUG 1
+	#endif
+#endif
+
+namespace LEN
+{
+	// 64-bit FNV-1a hash of a string. Stable across runs and platforms and computable at compile
+	// time, so it can be used in constexpr tables, switch-like comparisons and saved data.
+	// Equality is an integer compare; the text is only kept by Intern (and in debug builds).
+	class StringId
+	{
+	public:
+		constexpr StringId() = default;
+		constexpr explicit StringId(std::string_view text)
+			: m_hash(Hash(text))
+		{
+#if LEN_STRINGID_DEBUG
+			if (!std::is_constant_evaluated())
+			{
+				Register(m_hash, text);
+			}
+#endif
+		}
+
+		// Hashes and stores the text, so GetString() works in every build configuration.
+		// Needed where the string has to be recovered, e.g. for glGetUniformLocation.
+		static StringId Intern(std::string_view text);
+
+		// Id of a hash read back from saved data; its text is only known if it was hashed in this run
+		static constexpr StringId FromHash(uint64_t hash)
+		{
+			StringId id;
+			id.m_hash = hash;
+			return id;
+		}
+
+		// Interned text, or an empty view if the id was never interned (release builds) or is unknown
+		std::string_view GetString() const;
+
+		constexpr uint64_t GetHash() const { return m_hash; }
+		constexpr bool IsEmpty() const { return m_hash == 0; }
+
+		constexpr bool operator==(const StringId& other) const { return m_hash == other.m_hash; }
+		constexpr bool operator!=(const StringId& other) const { return m_hash != other.m_hash; }
+		constexpr bool operator<(const StringId& other) const { return m_hash < other.m_hash; }
+
+		static constexpr uint64_t Hash(std::string_view text)
+		{
+			if (text.empty())
+			{
+				return 0; // Keeps default constructed ids equal to the empty string
+			}
+			uint64_t hash = 14695981039346656037ull;
+			for (char c : text)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+	private:
+		static void Register(uint64_t hash, std::string_view text);
+
+		uint64_t m_hash = 0;
+	};
+
+	namespace Literals
+	{
+		// "uModel"_sid is hashed at compile time; it is not interned
+		consteval StringId operator""_sid(const char* text, size_t length)
+		{
+			return StringId(std::string_view(text, length));
+		}
+	}
+}
+
+template<>
+struct std::hash<LEN::StringId>
+{
+	size_t operator()(const LEN::StringId& id) const noexcept
+	{
+		return static_cast<size_t>(id.GetHash());
+	}
+};